@@ -0,0 +1,71 @@
+#pragma once
+
+#include <vector>
+#if defined(__AVX2__)
+#include <immintrin.h>
+#endif
+
+// 군중 에이전트 배열(SoA)을 구간 단위로 한꺼번에 처리하는 커널
+// AVX2로 컴파일하면(x64 구성은 /arch:AVX2) 에이전트 8명씩 처리하고, 아니면 같은 계산을 한 명씩 한다.
+// 구간 끝의 8명이 안 되는 나머지도 마스크를 씌운 같은 벡터 연산으로 처리하므로, 구간을 어떻게 나누어도 결과가 같다.
+
+// [begin, end) 에이전트의 진행률을 step * invDurations[i] * speeds[edges[i]]만큼 늘리고, 1 이상이 된 에이전트 번호를 completed에 추가하는 함수
+// 간선 위에 있지 않은 에이전트는 속도가 0인 간선 번호를 가리키게 해 두면 진행률이 변하지 않는다
+inline void advanceAgents(float* progress, const float* invDurations, const int* edges, const float* speeds,
+    int begin, int end, float step, std::vector<int>& completed) {
+#if defined(__AVX2__)
+    const __m256 steps = _mm256_set1_ps(step);
+    const __m256 ones = _mm256_set1_ps(1.0f);
+    const __m256i lanes = _mm256_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7);
+    for (int i = begin; i < end; i += 8) {
+        __m256i mask = _mm256_cmpgt_epi32(_mm256_set1_epi32(end - i), lanes); // 구간 안에 있는 레인만 참
+        __m256 p = _mm256_maskload_ps(progress + i, mask);
+        __m256 inv = _mm256_maskload_ps(invDurations + i, mask);
+        __m256i e = _mm256_maskload_epi32(edges + i, mask);
+        __m256 speed = _mm256_mask_i32gather_ps(_mm256_setzero_ps(), speeds, e, _mm256_castsi256_ps(mask), 4);
+        p = _mm256_add_ps(p, _mm256_mul_ps(_mm256_mul_ps(steps, inv), speed));
+        _mm256_maskstore_ps(progress + i, mask, p);
+
+        int done = _mm256_movemask_ps(_mm256_and_ps(_mm256_cmp_ps(p, ones, _CMP_GE_OQ), _mm256_castsi256_ps(mask)));
+        for (int lane = 0; done != 0; ++lane, done >>= 1) {
+            if (done & 1) completed.push_back(i + lane);
+        }
+    }
+#else
+    for (int i = begin; i < end; ++i) {
+        progress[i] += step * invDurations[i] * speeds[edges[i]];
+        if (progress[i] >= 1.0f) completed.push_back(i);
+    }
+#endif
+}
+
+// [begin, end) 에이전트의 위치를 출발 노드와 도착 노드 좌표 사이에서 진행률로 보간하는 함수 (도착 노드가 -1이면 출발 노드 위치)
+inline void interpolateAgents(const float* nodeX, const float* nodeY, const int* sources, const int* targets, const float* progress,
+    int begin, int end, float* outX, float* outY) {
+#if defined(__AVX2__)
+    const __m256i lanes = _mm256_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7);
+    const __m256 zero = _mm256_setzero_ps();
+    for (int i = begin; i < end; i += 8) {
+        __m256i mask = _mm256_cmpgt_epi32(_mm256_set1_epi32(end - i), lanes);
+        __m256 gatherMask = _mm256_castsi256_ps(mask);
+        __m256i from = _mm256_maskload_epi32(sources + i, mask);
+        __m256i to = _mm256_maskload_epi32(targets + i, mask);
+        to = _mm256_blendv_epi8(to, from, _mm256_cmpgt_epi32(_mm256_setzero_si256(), to));
+        __m256 p = _mm256_maskload_ps(progress + i, mask);
+
+        __m256 fromX = _mm256_mask_i32gather_ps(zero, nodeX, from, gatherMask, 4);
+        __m256 toX = _mm256_mask_i32gather_ps(zero, nodeX, to, gatherMask, 4);
+        _mm256_maskstore_ps(outX + i, mask, _mm256_add_ps(fromX, _mm256_mul_ps(_mm256_sub_ps(toX, fromX), p)));
+
+        __m256 fromY = _mm256_mask_i32gather_ps(zero, nodeY, from, gatherMask, 4);
+        __m256 toY = _mm256_mask_i32gather_ps(zero, nodeY, to, gatherMask, 4);
+        _mm256_maskstore_ps(outY + i, mask, _mm256_add_ps(fromY, _mm256_mul_ps(_mm256_sub_ps(toY, fromY), p)));
+    }
+#else
+    for (int i = begin; i < end; ++i) {
+        int to = targets[i] < 0 ? sources[i] : targets[i];
+        outX[i] = nodeX[sources[i]] + (nodeX[to] - nodeX[sources[i]]) * progress[i];
+        outY[i] = nodeY[sources[i]] + (nodeY[to] - nodeY[sources[i]]) * progress[i];
+    }
+#endif
+}
@@ -0,0 +1,245 @@
+#pragma once
+
+#include <vector>
+#include <string>
+#include <fstream>
+#include <sstream>
+#include <ostream>
+#include <chrono>
+#include <mutex>
+#include <atomic>
+#include <cstdint>
+#include <algorithm>
+#include <memory>
+
+#include "graph.h"
+#include "simulation.h"
+#include "thread_pool.h"
+#include "random.h"
+#include "replay.h"
+
+// 일괄 실행할 시나리오 한 건
+struct BatchScenario {
+    int startId = 0;  // 플레이어 출발 노드
+    std::vector<int> exits;  // 탈출구
+    std::vector<int> ignitions;  // 최초 발화 노드 (비어 있으면 seed로 하나를 고른다)
+    std::string planner = "time-aware";  // 경로 탐색기 이름 (SimulationConfig::planner)
+    std::uint64_t seed = 0;  // 발화 지점(정하지 않은 경우)과 군중 출발 위치를 정하는 시드
+};
+
+// 일괄 실행 설정
+struct BatchConfig {
+    int threads = 0;  // 동시에 실행할 시나리오 수 (0이면 하드웨어 스레드 수)
+    double fireTick = 3.0;  // 화재 확산 주기 (초)
+    double timeLimit = 3600.0;  // 시나리오 최대 시뮬레이션 시간 (초)
+    int agents = 0;  // 시나리오마다 플레이어와 함께 대피하는 군중 수
+    int crowdThreads = 1;  // 시나리오 안에서 군중을 갱신하는 스레드 수 (시나리오끼리 이미 병렬이므로 기본은 1)
+};
+
+// 시나리오 한 건의 결과
+struct BatchResult {
+    std::vector<int> ignitions;  // 실제 발화 노드 (시드로 고른 경우 포함)
+    AgentStatus status = AgentStatus::Moving;  // 제한 시간이 지나도 이동 중이면 Moving
+    double escapeTime = 0.0;  // 탈출한 시뮬레이션 시각 (탈출한 경우)
+    double totalWeight = 0.0;  // 지나온 간선 가중치의 합
+    double planSeconds = 0.0;  // 처음 경로를 찾는 데 걸린 실제 시간 (초)
+    int replans = 0;  // 경로 재계산 횟수
+    double replanSeconds = 0.0;  // 경로 재계산에 걸린 실제 시간 (초)
+    double wallSeconds = 0.0;  // 시나리오 전체에 걸린 실제 시간 (초)
+    int agentsEscaped = 0;
+    int agentsTrapped = 0;
+};
+
+// 시나리오 한 건을 헤드리스 시뮬레이션으로 끝까지 실행하는 함수
+// 시나리오를 스레드마다 하나씩 돌리므로 시나리오 안에서는 대체 경로를 미리 계산하지 않고 막힌 노드에서만 계산한다
+// replayPath가 비어 있지 않으면 실행 과정을 리플레이 파일로 기록한다
+inline BatchResult runBatchScenario(const Graph& graph, const std::vector<double>& travelTimes, const std::vector<double>& capacities,
+    const BatchScenario& scenario, const BatchConfig& config, const std::string& replayPath = std::string()) {
+    auto startTime = std::chrono::steady_clock::now();
+    Random random(scenario.seed);
+    BatchResult result;
+    result.ignitions = scenario.ignitions;
+    if (result.ignitions.empty()) result.ignitions.push_back(random.below(graph.size()));
+
+    SimulationConfig simulationConfig;
+    simulationConfig.playerId = scenario.startId;
+    simulationConfig.exits = scenario.exits;
+    simulationConfig.ignitions = result.ignitions;
+    simulationConfig.planner = scenario.planner;
+    simulationConfig.fireTick = config.fireTick;
+    simulationConfig.precomputeFallbacks = false;
+    simulationConfig.threads = config.crowdThreads;
+    Simulation simulation(graph, travelTimes, capacities, simulationConfig);
+    simulation.spawnAgents(config.agents, random);
+    std::unique_ptr<ReplayRecorder> recorder;
+    if (!replayPath.empty()) {
+        recorder.reset(new ReplayRecorder(replayPath));
+        recorder->attach(simulation);
+    }
+    simulation.runUntilDone(config.timeLimit);
+    recorder.reset(); // 마지막 상태를 기록하고 파일을 닫는다
+
+    result.status = simulation.status();
+    result.escapeTime = simulation.escapeTime();
+    result.totalWeight = simulation.totalWeight();
+    result.planSeconds = simulation.plannerStats().planSeconds;
+    result.replans = simulation.replans();
+    result.replanSeconds = simulation.replanSeconds();
+    result.agentsEscaped = simulation.crowd().escaped();
+    result.agentsTrapped = simulation.crowd().trapped();
+    result.wallSeconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - startTime).count();
+    return result;
+}
+
+// 시나리오들을 스레드 풀에서 병렬로 실행하고, 끝나는 대로 시나리오 순서에 맞춰 onResult(i, 결과)를 호출하는 함수
+// 앞 시나리오가 끝나기를 기다리는 결과만 잠시 들고 있으므로 결과 행은 실행 순서와 관계없이 입력 순서대로 나온다 (onResult는 한 번에 하나씩 호출된다)
+template <typename ResultFn>
+void runBatch(const Graph& graph, const std::vector<double>& travelTimes, const std::vector<double>& capacities,
+    const std::vector<BatchScenario>& scenarios, const BatchConfig& config, ResultFn onResult) {
+    int count = static_cast<int>(scenarios.size());
+    if (count == 0) return;
+    int threadCount = config.threads > 0 ? config.threads : static_cast<int>(std::thread::hardware_concurrency());
+    threadCount = std::max(1, std::min(threadCount, count));
+
+    std::vector<BatchResult> pending(count);
+    std::vector<char> finished(count, 0);
+    int nextOutput = 0;
+    std::mutex outputMutex;
+
+    std::atomic<int> nextScenario(0);
+    auto worker = [&]() {
+        for (int i = nextScenario++; i < count; i = nextScenario++) {
+            BatchResult result = runBatchScenario(graph, travelTimes, capacities, scenarios[i], config);
+            std::lock_guard<std::mutex> lock(outputMutex);
+            pending[i] = std::move(result);
+            finished[i] = 1;
+            for (; nextOutput < count && finished[nextOutput]; ++nextOutput) {
+                onResult(nextOutput, pending[nextOutput]);
+                pending[nextOutput] = BatchResult();
+            }
+        }
+    };
+
+    TaskGroup group(sharedPool());
+    for (int t = 1; t < threadCount; ++t) {
+        group.run(worker);
+    }
+    worker();
+    group.wait();
+}
+
+// 노드 목록을 공백으로 구분한 노드 코드 문자열로 바꾸는 함수
+inline std::string joinNodeCodes(const Graph& graph, const std::vector<int>& ids) {
+    std::string joined;
+    for (size_t i = 0; i < ids.size(); ++i) {
+        if (i > 0) joined += ' ';
+        joined += graph.codes[ids[i]];
+    }
+    return joined;
+}
+
+// 시나리오 CSV를 읽는 함수 (형식: start,exits,ignitions,planner,seed / exits와 ignitions는 공백으로 구분한 노드 코드)
+// exits가 비어 있으면 defaultExits, planner가 비어 있으면 defaultPlanner, seed가 비어 있으면 (defaultSeed, 행 번호) 스트림에서 뽑은 값을 쓴다
+// planner에는 등록된 탐색기 이름이나 예전 알고리즘 번호(1~5)를 쓸 수 있다
+// 형식이 잘못되었거나 없는 노드 코드나 탐색기 이름이 있으면 error에 이유를 채우고 false를 반환한다
+inline bool readBatchCSV(const std::string& filename, const Graph& graph, const std::vector<int>& defaultExits, const std::string& defaultPlanner,
+    std::uint64_t defaultSeed, std::vector<BatchScenario>& scenarios, std::string& error) {
+    std::ifstream file(filename);
+    if (!file) {
+        error = "Could not read " + filename;
+        return false;
+    }
+
+    auto parseNodes = [&](const std::string& field, std::vector<int>& ids) {
+        std::istringstream codes(field);
+        std::string code;
+        while (codes >> code) {
+            int id = graph.id(code);
+            if (id < 0) {
+                error = "Unknown node " + code;
+                return false;
+            }
+            ids.push_back(id);
+        }
+        return true;
+    };
+
+    // 부호 없는 10진수만 받는다 (숫자가 아닌 문자가 섞였거나 64비트 범위를 넘으면 false)
+    auto parseNumber = [](const std::string& field, std::uint64_t& value) {
+        if (field.empty() || field.find_first_not_of("0123456789") != std::string::npos) return false;
+        std::istringstream digits(field);
+        return static_cast<bool>(digits >> value);
+    };
+
+    std::string line;
+    std::getline(file, line); // 헤더
+    for (int row = 1; std::getline(file, line); ++row) {
+        if (!line.empty() && line.back() == '\r') line.pop_back();
+        if (line.empty()) continue;
+        std::vector<std::string> fields;
+        std::istringstream tokens(line);
+        for (std::string field; std::getline(tokens, field, ',');) {
+            fields.push_back(field);
+        }
+        fields.resize(std::max<size_t>(fields.size(), 5));
+
+        BatchScenario scenario;
+        std::vector<int> start;
+        if (!parseNodes(fields[0], start) || !parseNodes(fields[1], scenario.exits) || !parseNodes(fields[2], scenario.ignitions)) {
+            error += " in row " + std::to_string(row);
+            return false;
+        }
+        if (start.size() != 1) {
+            error = "Row " + std::to_string(row) + " needs exactly one start node";
+            return false;
+        }
+        scenario.startId = start[0];
+        if (scenario.exits.empty()) scenario.exits = defaultExits;
+        scenario.planner = fields[3].empty() ? defaultPlanner : fields[3];
+        if (!scenario.planner.empty() && scenario.planner.find_first_not_of("0123456789") == std::string::npos) {
+            // 범위를 벗어난 번호는 빈 이름이 되어 아래에서 알 수 없는 탐색기로 처리된다
+            std::uint64_t algorithm = 0;
+            bool valid = parseNumber(scenario.planner, algorithm) && algorithm <= 5;
+            scenario.planner = valid ? legacyPlannerName(static_cast<int>(algorithm)) : "";
+        }
+        if (!hasPlanner(scenario.planner)) {
+            error = "Unknown planner " + fields[3] + " in row " + std::to_string(row) + " (available: " + plannerNames() + ")";
+            return false;
+        }
+        if (fields[4].empty()) {
+            scenario.seed = Random(defaultSeed, static_cast<std::uint64_t>(row)).next();
+        } else if (!parseNumber(fields[4], scenario.seed)) {
+            error = "Invalid seed " + fields[4] + " in row " + std::to_string(row);
+            return false;
+        }
+        scenarios.push_back(scenario);
+    }
+    return true;
+}
+
+// 결과 CSV의 헤더와 행을 쓰는 함수
+inline void writeBatchHeader(std::ostream& out) {
+    out << "scenario,start,exits,ignitions,planner,seed,result,escape_time,total_weight,plan_time,replans,replan_time,wall_time,agents_escaped,agents_trapped\n";
+}
+
+// 결과 열에 쓰는 플레이어의 최종 상태 (제한 시간이 지나도 이동 중이면 time_limit)
+inline const char* outcomeName(AgentStatus status) {
+    switch (status) {
+    case AgentStatus::Escaped:
+        return "escaped";
+    case AgentStatus::NoInitialPath:
+        return "no_initial_path";
+    case AgentStatus::Trapped:
+        return "trapped";
+    case AgentStatus::Moving:
+        break;
+    }
+    return "time_limit";
+}
+
+inline void writeBatchRow(std::ostream& out, const Graph& graph, int index, const BatchScenario& scenario, const BatchResult& result) {
+    out << index << ',' << graph.codes[scenario.startId] << ',' << joinNodeCodes(graph, scenario.exits) << ','
+        << joinNodeCodes(graph, result.ignitions) << ',' << scenario.planner << ',' << scenario.seed << ',' << outcomeName(result.status) << ','
+        << result.escapeTime << ',' << result.totalWeight << ',' << result.planSeconds << ',' << result.replans << ',' << result.replanSeconds << ','
+        << result.wallSeconds << ',' << result.agentsEscaped << ',' << result.agentsTrapped << '\n';
+}
@@ -0,0 +1,110 @@
+#pragma once
+
+#include <vector>
+#include <chrono>
+#include <atomic>
+#include <thread>
+#include <cstdint>
+#include <algorithm>
+
+#include "graph.h"
+#include "simulation.h"
+#include "batch.h"
+#include "thread_pool.h"
+#include "random.h"
+
+// 분기 탐색 설정
+struct BranchConfig {
+    int branches = 1000;  // 공통 앞부분에서 갈라지는 미래 수
+    double splitTime = 15.0;  // 공통 앞부분을 진행할 시뮬레이션 시간 (초)
+    int spotFires = 1;  // 미래마다 다음 화재 틱에 새로 불이 붙는 노드 수 (아직 불타지 않는 노드 중에서 고른다)
+};
+
+// 갈라진 미래 하나의 결과
+struct BranchResult {
+    std::vector<int> spotFires;  // 이 미래에서 새로 불이 붙은 노드
+    AgentStatus status = AgentStatus::Moving;
+    double escapeTime = 0.0;
+    double totalWeight = 0.0;
+    int agentsEscaped = 0;
+    int agentsTrapped = 0;
+};
+
+// 분기 탐색 전체의 시간 (초)
+struct BranchTiming {
+    double prefixSeconds = 0.0;  // 공통 앞부분을 진행한 실제 시간
+    double snapshotSeconds = 0.0;  // 스냅샷을 만든 시간
+    double branchSeconds = 0.0;  // 모든 미래를 실행한 시간
+};
+
+// 시나리오를 splitTime까지 한 번만 진행해 스냅샷을 만든 뒤, 미래마다 스냅샷으로 되돌려 화재를 다르게 번지게 하고 끝까지 실행하는 함수
+// 스레드마다 시뮬레이션을 하나씩 두고 되돌리기를 반복하므로, 미래 하나의 비용은 앞부분을 다시 진행하지 않고 갈라진 뒤 고친 상태만 복사하는 만큼이다.
+// 미래 i의 발화 노드는 (시나리오 시드, i + 1) 스트림에서 뽑으므로 결과는 스레드 수와 관계없이 같다.
+inline std::vector<BranchResult> exploreBranches(const Graph& graph, const std::vector<double>& travelTimes, const std::vector<double>& capacities,
+    const BatchScenario& scenario, const BatchConfig& config, const BranchConfig& branchConfig, BranchTiming& timing) {
+    typedef std::chrono::steady_clock Clock;
+    Random random(scenario.seed);
+    SimulationConfig simulationConfig;
+    simulationConfig.playerId = scenario.startId;
+    simulationConfig.exits = scenario.exits;
+    simulationConfig.ignitions = scenario.ignitions;
+    if (simulationConfig.ignitions.empty()) simulationConfig.ignitions.push_back(random.below(graph.size()));
+    simulationConfig.planner = scenario.planner;
+    simulationConfig.fireTick = config.fireTick;
+    simulationConfig.precomputeFallbacks = false;
+    simulationConfig.threads = config.crowdThreads;
+
+    // 공통 앞부분
+    auto prefixStart = Clock::now();
+    Simulation prefix(graph, travelTimes, capacities, simulationConfig);
+    prefix.spawnAgents(config.agents, random);
+    prefix.runUntilDone(branchConfig.splitTime);
+    auto snapshotStart = Clock::now();
+    Simulation::Snapshot split = prefix.snapshot();
+    auto branchStart = Clock::now();
+    timing.prefixSeconds = std::chrono::duration<double>(snapshotStart - prefixStart).count();
+    timing.snapshotSeconds = std::chrono::duration<double>(branchStart - snapshotStart).count();
+
+    int count = std::max(0, branchConfig.branches);
+    std::vector<BranchResult> results(count);
+    int threadCount = config.threads > 0 ? config.threads : static_cast<int>(std::thread::hardware_concurrency());
+    threadCount = std::max(1, std::min(threadCount, count));
+
+    std::atomic<int> nextBranch(0);
+    auto run = [&](Simulation& simulation) {
+        for (int i = nextBranch++; i < count; i = nextBranch++) {
+            simulation.restore(split);
+
+            BranchResult& result = results[i];
+            Random branchRandom(scenario.seed, static_cast<std::uint64_t>(i) + 1);
+            const NodeBitset& burning = simulation.fireNodes();
+            for (int k = 0; k < branchConfig.spotFires; ++k) {
+                int node = branchRandom.below(graph.size());
+                for (int tries = 0; burning.test(node) && tries < graph.size(); ++tries) node = branchRandom.below(graph.size());
+                result.spotFires.push_back(node);
+            }
+            simulation.addIgnitions(result.spotFires);
+            simulation.runUntilDone(config.timeLimit);
+
+            const Simulation& finished = simulation; // 읽기만 하므로 군중을 복사하지 않는다
+            result.status = finished.status();
+            result.escapeTime = finished.escapeTime();
+            result.totalWeight = finished.totalWeight();
+            result.agentsEscaped = finished.crowd().escaped();
+            result.agentsTrapped = finished.crowd().trapped();
+        }
+    };
+
+    // 다른 스레드는 같은 설정의 시뮬레이션을 하나씩 만들어 되돌려 쓰고, 현재 스레드는 앞부분을 진행한 시뮬레이션을 그대로 쓴다
+    TaskGroup group(sharedPool());
+    for (int t = 1; t < threadCount; ++t) {
+        group.run([&]() {
+            Simulation simulation(graph, travelTimes, capacities, simulationConfig);
+            run(simulation);
+        });
+    }
+    run(prefix);
+    group.wait();
+    timing.branchSeconds = std::chrono::duration<double>(Clock::now() - branchStart).count();
+    return results;
+}
@@ -0,0 +1,44 @@
+#pragma once
+
+#include <memory>
+#include <atomic>
+#include <utility>
+
+// 복사 생성자로 사본을 만드는 기본 복사 방법
+struct CopyValue {
+    template <typename T>
+    std::shared_ptr<T> operator()(const T& value) const { return std::make_shared<T>(value); }
+};
+
+// 여러 곳이 같은 값을 나눠 갖다가, 고치려는 쪽만 그때 자기 사본을 만드는 값 (copy-on-write)
+// 복사는 참조만 늘리므로 크기와 관계없이 싸고, 한 번도 고치지 않은 값은 끝까지 하나만 남는다.
+// 서로 다른 스레드가 각자의 CopyOnWrite로 같은 값을 읽고 고쳐도 되지만, CopyOnWrite 하나를 여러 스레드가 함께 쓰면 안 된다.
+// Copy는 사본을 만드는 방법으로, 기본은 복사 생성자이고 파생 클래스를 가리키는 값은 clone 같은 가상 함수로 복사한다.
+template <typename T, typename Copy = CopyValue>
+class CopyOnWrite {
+public:
+    explicit CopyOnWrite(std::shared_ptr<T> value) : pointer(std::move(value)) {}
+
+    const T& operator*() const { return *pointer; }
+    const T* operator->() const { return pointer.get(); }
+
+    // 고치기 위한 참조 (다른 곳과 나눠 갖고 있으면 먼저 복사한다)
+    T& edit() {
+        if (pointer.use_count() > 1) {
+            pointer = Copy()(*pointer);
+        }
+        else {
+            std::atomic_thread_fence(std::memory_order_acquire); // 마지막으로 놓은 쪽의 읽기가 끝난 뒤에 고친다
+        }
+        return *pointer;
+    }
+
+    // 값이 있는지 (nullptr로 만들지 않았으면 항상 true)
+    explicit operator bool() const { return pointer != nullptr; }
+
+    // 다른 곳과 나눠 갖고 있는지 (다음 edit에서 복사하는지)
+    bool shared() const { return pointer.use_count() > 1; }
+
+private:
+    std::shared_ptr<T> pointer;
+};
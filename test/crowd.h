@@ -0,0 +1,335 @@
+#pragma once
+
+#include <vector>
+#include <cstdint>
+#include <limits>
+#include <cmath>
+#include <thread>
+#include <atomic>
+#include <algorithm>
+
+#include "graph.h"
+#include "node_bitset.h"
+#include "dynamic_sssp.h"
+#include "agent_kernel.h"
+#include "thread_pool.h"
+
+// 군중 에이전트 상태
+enum class CrowdStatus : std::uint8_t {
+    Moving,  // 탈출구를 향해 이동 중
+    Escaped,  // 탈출구에 도착
+    Trapped  // 어느 탈출구로도 가는 경로가 없음
+};
+
+// 에이전트 상태 변화 종류 (리플레이 기록용)
+enum class CrowdEvent : std::uint8_t {
+    Enter,  // 간선에 들어섬 (node는 도착 노드)
+    Arrive,  // 간선 끝 노드에 도착
+    Escape,  // 탈출구에 도착
+    Trap,  // 갈 수 있는 탈출구가 없음
+    Reroute  // 향하던 노드에 불이 붙어 출발 노드로 돌아감
+};
+
+// 에이전트 한 명의 상태 변화
+struct CrowdTransition {
+    int agent;
+    CrowdEvent event;
+    int node;  // Enter의 도착 노드 (나머지는 -1)
+};
+
+// 혼잡 설정 (간선 위 인원에 따라 이동 속도를 줄이는 기본 도표, fundamental diagram)
+struct CongestionConfig {
+    double minSpeed = 0.1;  // 꽉 막힌 간선에서의 속도 (자유 속도 대비 비율, 0이면 정체가 풀리지 않을 수 있다)
+    double minChange = 0.05;  // 혼잡 비용이 이 비율 이상 변한 간선만 경로 트리에 반영한다
+};
+
+// 수만 명의 에이전트가 동시에 대피하는 군중 시뮬레이션
+// 에이전트마다 경로를 들고 있지 않고, 현재 간선(출발/도착 노드)과 진행률만 배열(SoA)로 저장한다.
+// 노드에 도착한 에이전트의 다음 이동은 탈출구별 최단 경로 트리(ExitTree)에서 찾으며,
+// 같은 노드에서 출발하는 요청은 한 번만 계산해 모든 에이전트가 나눠 쓴다.
+class Crowd {
+public:
+    // travelTimes[e]는 에이전트가 간선 e를 지나는 데 걸리는 시간, exits는 탈출구별 최단 경로 트리 (트리는 호출한 쪽이 갱신한다)
+    Crowd(const Graph& graph, const std::vector<double>& travelTimes, const std::vector<const ExitTree*>& exits, int threads = 0)
+        : graph(&graph), travelTimes(travelTimes), exits(exits), exitNodes(graph.size()),
+          occupancy(graph.targets.size()), speeds(graph.targets.size() + 1, 1.0f), reportedCosts(graph.weights),
+          hopNodes(graph.size(), -1), hopStamps(graph.size(), 0), generation(1), now(0.0),
+          escapedCount(0), trappedCount(0), recording(false) {
+        this->threads = threads > 0 ? threads : std::max(1, static_cast<int>(std::thread::hardware_concurrency()));
+        for (auto& count : occupancy) {
+            count.store(0, std::memory_order_relaxed);
+        }
+        speeds[idleEdge()] = 0.0f;
+        for (const ExitTree* tree : exits) {
+            exitNodes.set(tree->exit());
+        }
+    }
+
+    // 시뮬레이션 스냅샷용 복사 (간선 인원은 복사 시점의 값으로 시작한다)
+    Crowd(const Crowd& other)
+        : graph(other.graph), travelTimes(other.travelTimes), exits(other.exits), exitNodes(other.exitNodes), threads(other.threads),
+          sources(other.sources), targets(other.targets), edges(other.edges), invDurations(other.invDurations),
+          progresses(other.progresses), statuses(other.statuses), escapeTimes(other.escapeTimes), waiting(other.waiting),
+          occupancy(other.occupancy.size()), jamCounts(other.jamCounts), speeds(other.speeds), reportedCosts(other.reportedCosts),
+          congestion(other.congestion), hopNodes(other.hopNodes), hopStamps(other.hopStamps), generation(other.generation),
+          now(other.now), escapedCount(other.escapedCount), trappedCount(other.trappedCount),
+          recording(other.recording), transitionLog(other.transitionLog) {
+        for (size_t e = 0; e < occupancy.size(); ++e) {
+            occupancy[e].store(other.occupancy[e].load(std::memory_order_relaxed), std::memory_order_relaxed);
+        }
+    }
+
+    Crowd& operator=(const Crowd&) = delete;
+
+    // 탈출구 트리를 같은 내용의 다른 트리로 바꾸는 함수 (트리를 복사해 옮긴 경우, 탈출구 순서는 같아야 한다)
+    void setExits(const std::vector<const ExitTree*>& exits) { this->exits = exits; }
+    const std::vector<const ExitTree*>& exitTrees() const { return exits; }
+
+    // 간선 위 인원에 따라 속도를 줄이는 혼잡 모델을 켜는 함수 (capacities[e]는 간선 e의 초당 통과 인원)
+    // Greenshields 모델: 속도 = 자유 속도 * (1 - 밀도 / 정체 밀도). 통과량(밀도 * 속도)은 정체 밀도의 절반에서 가장 크므로,
+    // 그때의 통과량이 간선 용량이 되도록 정체 인원을 4 * 용량 * 자유 통과 시간으로 둔다
+    void enableCongestion(const std::vector<double>& capacities, const CongestionConfig& config) {
+        congestion = config;
+        jamCounts.resize(graph->targets.size());
+        for (size_t e = 0; e < jamCounts.size(); ++e) {
+            jamCounts[e] = static_cast<float>(std::max(1.0, 4.0 * capacities[e] * travelTimes[e]));
+        }
+    }
+
+    // 혼잡을 반영한 간선 비용(baseCosts[e] / 속도 비율) 중 마지막으로 반영한 값에서 충분히 변한 간선을 changes에 채우는 함수
+    // 호출한 쪽이 탈출구 트리에 changes를 넘겨 경로를 다시 가중한다 (혼잡 모델이 꺼져 있으면 baseCosts의 변화만 전달된다)
+    void reweight(const std::vector<double>& baseCosts, std::vector<EdgeCostChange>& changes) {
+        changes.clear();
+        for (int u = 0; u < graph->size(); ++u) {
+            for (int e = graph->offsets[u]; e < graph->offsets[u + 1]; ++e) {
+                double cost = baseCosts[e] / speedRatio(e);
+                if (std::fabs(cost - reportedCosts[e]) > congestion.minChange * reportedCosts[e]) {
+                    reportedCosts[e] = cost;
+                    changes.push_back({ u, e, cost });
+                }
+            }
+        }
+        if (!changes.empty()) generation++; // 트리가 바뀔 것이므로 노드별 다음 이동 캐시를 무효화
+    }
+
+    // 에이전트 상태 변화를 transitions()에 모을지 정하는 함수 (모은 변화는 호출한 쪽이 읽고 비운다)
+    // 상태 변화는 모두 단일 스레드 구간에서 에이전트 번호 순으로 추가되므로 스레드 수와 관계없이 순서가 같다
+    void recordTransitions(bool enabled) {
+        recording = enabled;
+        transitionLog.clear();
+    }
+
+    std::vector<CrowdTransition>& transitions() { return transitionLog; }
+
+    // node에 에이전트를 추가하는 함수 (에이전트 번호를 반환, 경로는 다음 update에서 정해진다)
+    int add(int node) {
+        int id = static_cast<int>(statuses.size());
+        sources.push_back(node);
+        targets.push_back(-1);
+        edges.push_back(idleEdge());
+        invDurations.push_back(0.0f);
+        progresses.push_back(0.0f);
+        statuses.push_back(CrowdStatus::Moving);
+        escapeTimes.push_back(0.0f);
+        if (exitNodes.test(node)) {
+            escape(id);
+        }
+        else {
+            waiting.push_back(id);
+        }
+        return id;
+    }
+
+    // 탈출구 트리가 갱신된 뒤 호출: 새로 불붙은 노드로 향하던 에이전트는 출발 노드로 돌아가 경로를 다시 찾는다 (게임 화면과 같은 규칙)
+    void onFire(const NodeBitset& fireNodes) {
+        generation++; // 트리가 바뀌었으므로 노드별 다음 이동 캐시를 무효화
+        std::vector<std::vector<int>> rerouted(threads);
+        parallelFor(size(), threads, [&](int begin, int end, int chunk) {
+            for (int i = begin; i < end; ++i) {
+                if (statuses[i] != CrowdStatus::Moving || targets[i] < 0 || !fireNodes.test(targets[i])) continue;
+                occupancy[edges[i]].fetch_sub(1, std::memory_order_relaxed);
+                targets[i] = -1;
+                edges[i] = idleEdge();
+                progresses[i] = 0.0f;
+                rerouted[chunk].push_back(i);
+            }
+        });
+        for (const auto& list : rerouted) {
+            waiting.insert(waiting.end(), list.begin(), list.end());
+            if (recording) {
+                for (int i : list) transitionLog.push_back({ i, CrowdEvent::Reroute, -1 });
+            }
+        }
+    }
+
+    // 모든 에이전트를 dt초만큼 이동시키는 함수
+    void update(double dt) {
+        now += dt;
+        routeWaiting();
+
+        // 이번 틱의 간선별 속도는 틱 시작 시점의 인원으로 정한다 (틱 도중의 증감은 다음 틱에 반영되므로 스레드 수와 무관하게 결과가 같다)
+        if (!jamCounts.empty()) {
+            for (int e = 0; e < idleEdge(); ++e) {
+                speeds[e] = speedRatio(e);
+            }
+        }
+
+        // 1단계: 간선 위의 에이전트를 병렬로 전진시키고(SIMD 커널), 노드에 도착한 에이전트를 모은다 (간선 인원은 원자적으로 줄인다)
+        // 간선 위에 있지 않은 에이전트는 속도가 0인 idleEdge()를 가리키므로 상태를 따로 확인하지 않는다
+        std::vector<std::vector<int>> arrived(threads);
+        float step = static_cast<float>(dt);
+        parallelFor(size(), threads, [&](int begin, int end, int chunk) {
+            advanceAgents(progresses.data(), invDurations.data(), edges.data(), speeds.data(), begin, end, step, arrived[chunk]);
+            for (int i : arrived[chunk]) {
+                occupancy[edges[i]].fetch_sub(1, std::memory_order_relaxed);
+                sources[i] = targets[i];
+                targets[i] = -1;
+                edges[i] = idleEdge();
+                progresses[i] = 0.0f;
+            }
+        });
+
+        // 2단계: 탈출구에 도착한 에이전트를 처리하고, 나머지는 다음 update에서 다음 간선을 배정받는다
+        for (const auto& list : arrived) {
+            for (int i : list) {
+                if (recording) transitionLog.push_back({ i, CrowdEvent::Arrive, -1 });
+                if (exitNodes.test(sources[i])) {
+                    escape(i);
+                }
+                else {
+                    waiting.push_back(i);
+                }
+            }
+        }
+    }
+
+    // 간선 위의 에이전트 중 가장 먼저 간선 끝에 도착하는 에이전트까지 남은 시간 (현재 인원으로 정한 속도 기준, 이동 중인 에이전트가 없으면 무한대)
+    // 다음 간선을 기다리는 에이전트가 있으면 다음 update에서 바로 출발해야 하므로 0
+    double nextArrival() const {
+        if (!waiting.empty()) return 0.0;
+        double earliest = std::numeric_limits<double>::infinity();
+        for (int i = 0; i < size(); ++i) {
+            if (edges[i] == idleEdge()) continue;
+            double rate = static_cast<double>(invDurations[i]) * speedRatio(edges[i]);
+            if (rate > 0.0) earliest = std::min(earliest, (1.0 - progresses[i]) / rate);
+        }
+        return earliest;
+    }
+
+    int size() const { return static_cast<int>(statuses.size()); }
+    int escaped() const { return escapedCount; }
+    int trapped() const { return trappedCount; }
+    bool finished() const { return escapedCount + trappedCount == size(); }
+    double time() const { return now; }
+
+    int source(int i) const { return sources[i]; }
+    int target(int i) const { return targets[i]; }  // 경로를 기다리는 중이면 -1
+    float progress(int i) const { return progresses[i]; }
+    CrowdStatus status(int i) const { return statuses[i]; }
+    float speed(int i) const { return speeds[edges[i]]; }  // 마지막 update에서 이동한 속도 (자유 속도 대비 비율, 간선 위에 있지 않으면 0)
+
+    // 모든 에이전트의 화면 위치를 x, y에 채우는 함수 (nodeX, nodeY는 노드 ID별 좌표, 경로를 기다리는 에이전트는 노드 위치)
+    void positions(const std::vector<float>& nodeX, const std::vector<float>& nodeY, std::vector<float>& x, std::vector<float>& y) const {
+        x.resize(size());
+        y.resize(size());
+        parallelFor(size(), threads, [&](int begin, int end, int) {
+            interpolateAgents(nodeX.data(), nodeY.data(), sources.data(), targets.data(), progresses.data(), begin, end, x.data(), y.data());
+        });
+    }
+    float escapeTime(int i) const { return escapeTimes[i]; }
+
+    // 간선 e 위에 있는 에이전트 수
+    int occupants(int e) const { return occupancy[e].load(std::memory_order_relaxed); }
+
+    // 간선 e의 현재 이동 속도 (자유 속도 대비 비율, 혼잡 모델이 꺼져 있으면 1)
+    // 혼자 지나는 에이전트는 자유 속도로 걷도록 자신을 뺀 인원을 밀도로 쓴다
+    float speedRatio(int e) const {
+        if (jamCounts.empty()) return 1.0f;
+        int others = std::max(0, occupants(e) - 1);
+        return std::max(static_cast<float>(congestion.minSpeed), 1.0f - others / jamCounts[e]);
+    }
+
+private:
+    // 간선 위에 있지 않은 에이전트가 가리키는 가상의 간선 번호 (속도 0)
+    int idleEdge() const { return static_cast<int>(graph->targets.size()); }
+
+    // 노드에서 가장 가까운 탈출구 방향의 다음 노드 (여러 에이전트가 같은 노드에서 기다리면 한 번만 계산한다)
+    int hopFrom(int node) {
+        if (hopStamps[node] == generation) return hopNodes[node];
+        int bestHop = -1;
+        double bestCost = std::numeric_limits<double>::infinity();
+        for (const ExitTree* tree : exits) {
+            std::pair<int, double> hop = tree->firstHop(node);
+            if (hop.first >= 0 && hop.second < bestCost) {
+                bestHop = hop.first;
+                bestCost = hop.second;
+            }
+        }
+        hopNodes[node] = bestHop;
+        hopStamps[node] = generation;
+        return bestHop;
+    }
+
+    // 다음 간선을 기다리는 에이전트들에게 출발 노드별로 묶어 다음 간선을 배정하는 함수
+    void routeWaiting() {
+        for (int i : waiting) {
+            if (statuses[i] != CrowdStatus::Moving) continue;
+            int hop = hopFrom(sources[i]);
+            if (hop < 0) {
+                statuses[i] = CrowdStatus::Trapped;
+                trappedCount++;
+                if (recording) transitionLog.push_back({ i, CrowdEvent::Trap, -1 });
+                continue;
+            }
+            targets[i] = hop;
+            edges[i] = graph->edge(sources[i], hop);
+            invDurations[i] = static_cast<float>(1.0 / travelTimes[edges[i]]);
+            occupancy[edges[i]].fetch_add(1, std::memory_order_relaxed);
+            if (recording) transitionLog.push_back({ i, CrowdEvent::Enter, hop });
+        }
+        waiting.clear();
+    }
+
+    void escape(int i) {
+        statuses[i] = CrowdStatus::Escaped;
+        escapeTimes[i] = static_cast<float>(now);
+        escapedCount++;
+        if (recording) transitionLog.push_back({ i, CrowdEvent::Escape, -1 });
+    }
+
+    const Graph* graph;
+    std::vector<double> travelTimes;
+    std::vector<const ExitTree*> exits;
+    NodeBitset exitNodes;  // 탈출구 노드
+    int threads;
+
+    // 에이전트별 상태 (SoA)
+    std::vector<int> sources;  // 현재 간선의 출발 노드 (노드 위에 있으면 그 노드)
+    std::vector<int> targets;  // 현재 간선의 도착 노드 (다음 간선을 기다리는 중이면 -1)
+    std::vector<int> edges;  // 현재 간선 번호 (간선 위에 있지 않으면 idleEdge())
+    std::vector<float> invDurations;  // 현재 간선을 지나는 데 걸리는 시간의 역수 (초당 진행률)
+    std::vector<float> progresses;  // 현재 간선의 진행률 (0 ~ 1)
+    std::vector<CrowdStatus> statuses;
+    std::vector<float> escapeTimes;  // 탈출한 시각
+
+    std::vector<int> waiting;  // 다음 간선을 기다리는 에이전트
+
+    // 간선별 혼잡 상태
+    std::vector<std::atomic<int>> occupancy;  // 간선 위 인원 (병렬 갱신 중에도 락 없이 원자적으로 증감)
+    std::vector<float> jamCounts;  // 간선별 정체 인원 (비어 있으면 혼잡 모델을 쓰지 않는다)
+    std::vector<float> speeds;  // 이번 틱의 간선별 속도 비율 (마지막 칸은 idleEdge()의 0)
+    std::vector<double> reportedCosts;  // 간선별로 마지막으로 탈출구 트리에 반영한 비용
+    CongestionConfig congestion;
+
+    // 노드별 다음 이동 캐시 (hopStamps[node] == generation일 때만 유효)
+    std::vector<int> hopNodes;
+    std::vector<std::uint32_t> hopStamps;
+    std::uint32_t generation;
+
+    double now;
+    int escapedCount;
+    int trappedCount;
+
+    bool recording;  // 상태 변화를 모으는지
+    std::vector<CrowdTransition> transitionLog;
+};
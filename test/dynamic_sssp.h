@@ -0,0 +1,220 @@
+#pragma once
+
+#include <vector>
+#include <queue>
+#include <limits>
+#include <functional>
+#include <utility>
+#include <algorithm>
+
+#include "graph.h"
+#include "node_bitset.h"
+
+// 간선 비용 변경 (from -> 간선 edge의 새 비용)
+struct EdgeCostChange {
+    int from;
+    int edge;
+    double cost;
+};
+
+// 탈출구까지의 최단 경로 트리를 화재로 인한 노드 삭제와 간선 비용 변화에 맞춰 점진적으로 갱신하는 클래스
+// (Ramalingam-Reps 방식: 불탄 노드나 비용이 오른 트리 간선에 매달린 서브트리만 무효화한 뒤 다시 붙인다)
+// 조회 함수는 상태를 바꾸지 않으므로 여러 스레드가 락 없이 함께 읽을 수 있고, 갱신은 CopyOnWrite로 나눠 갖지 않은 사본에만 한다
+class ExitTree {
+public:
+    ExitTree(const Graph& graph, int exitId)
+        : graph(&graph), exitId(exitId), costs(graph.weights), reverseCosts(graph.reverseWeights),
+          reverseSlots(graph.targets.size()),
+          dist(graph.size(), std::numeric_limits<double>::infinity()),
+          next(graph.size(), -1), removed(graph.size()), affected(graph.size()) {
+        for (size_t slot = 0; slot < graph.reverseEdges.size(); ++slot) {
+            reverseSlots[graph.reverseEdges[slot]] = static_cast<int>(slot);
+        }
+        build();
+    }
+
+    // 화재가 새로 발생한 노드들을 트리에서 삭제하고 영향받은 서브트리를 다시 연결하는 함수
+    void removeNodes(const std::vector<int>& burned) {
+        // 1단계: 삭제된 노드에 매달린 서브트리를 찾아 거리를 무효화한다
+        std::vector<int> invalidated;
+        for (int d : burned) {
+            if (!removed.insert(d)) continue;
+            if (!affected.insert(d)) continue;
+            invalidated.push_back(d);
+        }
+        invalidateSubtrees(invalidated);
+
+        // 2단계: 영향받지 않은 이웃을 통해 각 노드의 임시 거리를 구한다
+        Queue queue;
+        reconnect(invalidated, queue);
+
+        // 3단계: 영향받은 노드들 사이에서만 다익스트라로 거리를 전파한다
+        // (삭제는 거리를 늘리기만 하므로 영향받지 않은 노드의 거리는 그대로 유효하다)
+        relax(queue, true);
+
+        for (int u : invalidated) affected.reset(u);
+    }
+
+    // 한 틱 동안 모인 간선 비용 변화를 한꺼번에 반영하는 함수
+    // 비용이 오른 트리 간선은 그 아래 서브트리만 무효화하고, 비용이 내린 간선은 출발 노드부터 거리 감소를 전파한다
+    void updateEdgeCosts(const std::vector<EdgeCostChange>& changes) {
+        if (changes.empty()) return;
+
+        std::vector<int> invalidated;
+        std::vector<EdgeCostChange> decreased;
+        for (const EdgeCostChange& change : changes) {
+            double old = costs[change.edge];
+            costs[change.edge] = change.cost;
+            reverseCosts[reverseSlots[change.edge]] = change.cost;
+
+            int u = change.from;
+            int v = graph->targets[change.edge];
+            if (removed.test(u) || removed.test(v)) continue;
+            if (change.cost > old && next[u] == v) {
+                if (affected.insert(u)) invalidated.push_back(u);
+            }
+            else if (change.cost < old) {
+                decreased.push_back(change);
+            }
+        }
+        invalidateSubtrees(invalidated);
+
+        Queue queue;
+        reconnect(invalidated, queue);
+        for (const EdgeCostChange& change : decreased) {
+            int v = graph->targets[change.edge];
+            if (affected.test(v)) continue; // 무효화된 노드는 다시 연결된 뒤 전파 과정에서 처리된다
+            double alt = costs[change.edge] + dist[v];  // 같은 틱에 같은 간선이 여러 번 바뀌었을 수 있으므로 최종 비용을 쓴다
+            if (alt < dist[change.from]) {
+                dist[change.from] = alt;
+                next[change.from] = v;
+                queue.push({ alt, change.from });
+            }
+        }
+        // 비용이 내린 간선이 있으면 영향받지 않은 노드의 거리도 줄어들 수 있으므로 전체 노드를 대상으로 전파한다
+        relax(queue, decreased.empty());
+
+        for (int u : invalidated) affected.reset(u);
+    }
+
+    // 트리의 뿌리인 탈출구 노드
+    int exit() const { return exitId; }
+
+    // 노드에서 탈출구까지의 최단 거리 (도달할 수 없으면 무한대)
+    double distance(int node) const { return dist[node]; }
+
+    // 최단 경로 트리에서 탈출구 방향의 다음 노드 (없으면 -1)
+    int nextHop(int node) const { return next[node]; }
+
+    // 노드에서 탈출구 방향으로 처음 이동할 노드와 탈출구까지의 비용 (경로가 없으면 (-1, 무한대))
+    // pathFrom과 같이, 시작 노드가 불타고 있으면 불타지 않은 이웃 중 탈출구에 가장 가까운 노드로 빠져나간다
+    std::pair<int, double> firstHop(int start) const {
+        if (!removed.test(start) || start == exitId) return { next[start], dist[start] };
+        double best = std::numeric_limits<double>::infinity();
+        int first = -1;
+        for (int e = graph->offsets[start]; e < graph->offsets[start + 1]; ++e) {
+            int v = graph->targets[e];
+            if (!removed.test(v) && costs[e] + dist[v] < best) {
+                best = costs[e] + dist[v];
+                first = v;
+            }
+        }
+        return { first, best };
+    }
+
+    // 노드에서 탈출구까지의 경로를 트리를 따라 구성하는 함수 (경로가 없으면 빈 벡터)
+    // 시작 노드 자체가 불타고 있어도 불타지 않은 이웃으로 빠져나가는 경로를 찾는다
+    std::vector<int> pathFrom(int start) const {
+        std::pair<int, double> hop = firstHop(start);
+        if (hop.second == std::numeric_limits<double>::infinity()) return {};
+
+        std::vector<int> path;
+        int first = start;
+        if (removed.test(start) && start != exitId) {
+            path.push_back(start);
+            first = hop.first;
+        }
+        for (int at = first; at != -1; at = next[at]) {
+            path.push_back(at);
+        }
+        return path;
+    }
+
+private:
+    typedef std::pair<double, int> Entry;
+    typedef std::priority_queue<Entry, std::vector<Entry>, std::greater<Entry>> Queue;
+
+    // 탈출구에서 역방향 간선을 따라 전체 트리를 처음 구성하는 함수
+    void build() {
+        Queue queue;
+        dist[exitId] = 0.0;
+        queue.push({ 0.0, exitId });
+        relax(queue, false);
+    }
+
+    // 무효화된 노드들(affected에 표시됨)에 매달린 서브트리를 찾아 함께 무효화하는 함수
+    void invalidateSubtrees(std::vector<int>& invalidated) {
+        for (size_t i = 0; i < invalidated.size(); ++i) {
+            int u = invalidated[i];
+            // u를 다음 노드로 삼고 있던 노드들이 트리상의 자식
+            for (int e = graph->reverseOffsets[u]; e < graph->reverseOffsets[u + 1]; ++e) {
+                int child = graph->sources[e];
+                if (next[child] == u && affected.insert(child)) {
+                    invalidated.push_back(child);
+                }
+            }
+        }
+        for (int u : invalidated) {
+            dist[u] = std::numeric_limits<double>::infinity();
+            next[u] = -1;
+        }
+    }
+
+    // 무효화된 노드마다 영향받지 않은 이웃을 통한 임시 거리를 구해 큐에 넣는 함수
+    void reconnect(const std::vector<int>& invalidated, Queue& queue) {
+        for (int u : invalidated) {
+            if (removed.test(u)) continue;
+            for (int e = graph->offsets[u]; e < graph->offsets[u + 1]; ++e) {
+                int v = graph->targets[e];
+                if (removed.test(v) || affected.test(v)) continue;
+                double alt = costs[e] + dist[v];
+                if (alt < dist[u]) {
+                    dist[u] = alt;
+                    next[u] = v;
+                }
+            }
+            if (dist[u] < std::numeric_limits<double>::infinity()) queue.push({ dist[u], u });
+        }
+    }
+
+    // 역방향 다익스트라 (onlyAffected가 참이면 무효화된 노드만 갱신한다)
+    void relax(Queue& queue, bool onlyAffected) {
+        while (!queue.empty()) {
+            Entry top = queue.top();
+            queue.pop();
+            int u = top.second;
+            if (top.first > dist[u]) continue;
+
+            for (int e = graph->reverseOffsets[u]; e < graph->reverseOffsets[u + 1]; ++e) {
+                int w = graph->sources[e];
+                if (removed.test(w) || (onlyAffected && !affected.test(w))) continue;
+                double alt = dist[u] + reverseCosts[e];
+                if (alt < dist[w]) {
+                    dist[w] = alt;
+                    next[w] = u;
+                    queue.push({ alt, w });
+                }
+            }
+        }
+    }
+
+    const Graph* graph;
+    int exitId;
+    std::vector<double> costs;  // 간선별 현재 비용 (처음에는 가중치)
+    std::vector<double> reverseCosts;  // 들어오는 간선별 현재 비용
+    std::vector<int> reverseSlots;  // 나가는 간선 번호 -> 들어오는 간선 배열의 위치
+    std::vector<double> dist;  // 탈출구까지의 거리
+    std::vector<int> next;  // 트리상 부모 (탈출구 방향의 다음 노드)
+    NodeBitset removed;  // 불에 타서 삭제된 노드
+    NodeBitset affected;  // 이번 갱신에서 무효화된 노드 표시
+};
@@ -0,0 +1,209 @@
+#pragma once
+
+#include <vector>
+#include <queue>
+#include <limits>
+#include <cmath>
+#include <utility>
+#include <algorithm>
+
+#include "graph.h"
+
+// 같은 경로와 출발 시각으로 움직이는 인원 묶음
+struct EvacuationGroup {
+    int source;  // 출발 노드
+    int exit;  // 도착 탈출구
+    int count;  // 인원
+    int arrival;  // 탈출구에 도착하는 시간 단계
+    std::vector<int> nodes;  // 경로 (노드 ID)
+    std::vector<int> departures;  // 경로의 각 간선에 들어서는 시간 단계 (nodes.size() - 1개)
+};
+
+// 전체 대피 계획
+struct EvacuationPlan {
+    std::vector<EvacuationGroup> groups;
+    int makespan = 0;  // 마지막 인원이 탈출하는 시간 단계
+    int unrouted = 0;  // 탈출구로 가는 경로가 없는 인원
+    int searches = 0;  // 경로 탐색 횟수 (재사용된 경로는 세지 않는다)
+};
+
+// 시간 확장 네트워크에서 모든 인원의 경로와 출발 시각을 정하는 대피 계획기
+// 간선 e는 transitSteps[e] 단계에 걸쳐 지나고, 한 단계에 평균 capacityPerStep[e]명까지 들어설 수 있으며, 노드에서는 얼마든지 기다릴 수 있다.
+// 단계당 용량이 정수가 아니면 누적 용량의 정수 부분이 늘어나는 만큼 단계마다 나눠 준다 (1.5명이면 1, 2, 1, 2, ...명).
+// 아직 남은 인원이 있는 노드들에서 가장 일찍 탈출구에 도착하는 경로를 찾아 그 경로의 여유 용량만큼 인원을 보내는 과정을 반복한다
+// (용량 제약 경로 계획, CCRP).
+// 시간 확장 네트워크의 (노드, 시각) 복사본은 만들지 않고, 간선마다 시간 단계별 사용량 배열만 두어 필요한 단계까지만 늘린다.
+class EvacuationPlanner {
+public:
+    EvacuationPlanner(const Graph& graph, const std::vector<int>& transitSteps, const std::vector<double>& capacityPerStep)
+        : graph(&graph), transitSteps(transitSteps), capacityPerStep(capacityPerStep),
+          loads(graph.targets.size()), nextSlots(graph.targets.size()) {}
+
+    // occupants[v]명이 노드 v에 있을 때 exits 중 한 곳으로 모두 내보내는 계획을 세우는 함수
+    EvacuationPlan plan(std::vector<int> occupants, const std::vector<int>& exits) {
+        const int INF = std::numeric_limits<int>::max();
+        int n = graph->size();
+        EvacuationPlan result;
+        for (auto& load : loads) load.clear();
+        for (auto& next : nextSlots) next.clear();
+
+        std::vector<bool> isExit(n, false);
+        for (int exitId : exits) isExit[exitId] = true;
+        for (int v = 0; v < n; ++v) {
+            if (isExit[v] && occupants[v] > 0) {
+                result.groups.push_back({ v, v, occupants[v], 0, { v }, {} }); // 탈출구에 있는 인원은 바로 나간다
+                occupants[v] = 0;
+            }
+        }
+
+        // 출발 노드별로 마지막에 찾은 경로: 다음에 다시 평가했을 때 가장 이른 도착 시각 그대로이면 탐색 없이 재사용한다
+        std::vector<std::vector<int>> cachedRoutes(n);
+        int earliest = 0; // 용량은 줄어들기만 하므로, 마지막 탐색의 가장 이른 도착 시각은 이후 모든 경로의 하한
+        std::vector<int> route, departures;
+
+        while (true) {
+            int source = -1;
+            int arrival = INF;
+            for (int v = 0; v < n && source < 0; ++v) {
+                if (occupants[v] == 0 || cachedRoutes[v].empty()) continue;
+                if (schedule(cachedRoutes[v], departures) == earliest) {
+                    source = v;
+                    route = cachedRoutes[v];
+                    arrival = earliest;
+                }
+            }
+            if (source < 0) {
+                result.searches++;
+                arrival = search(occupants, isExit, route);
+                if (arrival == INF) break; // 남은 인원은 어느 탈출구로도 갈 수 없다
+                source = route.front();
+                schedule(route, departures);
+                cachedRoutes[source] = route;
+                earliest = arrival;
+            }
+
+            // 경로의 여유 용량과 남은 인원 중 작은 만큼 보낸다
+            int count = occupants[source];
+            for (size_t i = 0; i + 1 < route.size(); ++i) {
+                int e = graph->edge(route[i], route[i + 1]);
+                count = std::min(count, slotCapacity(e, departures[i]) - load(e, departures[i]));
+            }
+            for (size_t i = 0; i + 1 < route.size(); ++i) {
+                reserve(graph->edge(route[i], route[i + 1]), departures[i], count);
+            }
+            occupants[source] -= count;
+            result.groups.push_back({ source, route.back(), count, arrival, route, departures });
+            result.makespan = std::max(result.makespan, arrival);
+        }
+
+        for (int v = 0; v < n; ++v) {
+            result.unrouted += occupants[v];
+        }
+        return result;
+    }
+
+private:
+    // 간선 e에 time 단계에 들어설 수 있는 인원 (0 단계부터의 누적 용량을 내림한 값의 차, 단계당 용량이 0 이하이면 1명)
+    int slotCapacity(int e, int time) const {
+        const double EPS = 1e-9; // 1.5 * 2 같은 값이 3보다 조금 작게 계산되어도 내림이 한 칸 밀리지 않게 한다
+        double rate = capacityPerStep[e];
+        if (rate <= 0.0) return 1;
+        return static_cast<int>(std::floor((time + 1) * rate + EPS)) - static_cast<int>(std::floor(time * rate + EPS));
+    }
+
+    // 간선 e의 time 단계 사용량
+    int load(int e, int time) const {
+        return time < static_cast<int>(loads[e].size()) ? loads[e][time] : 0;
+    }
+
+    // time 단계 이후 간선 e에 들어설 수 있는 가장 이른 단계
+    // 가득 찬 단계(용량이 0인 단계 포함)는 다음 단계를 가리키게 해 두고, 따라간 경로를 압축하여(유니온 파인드) 긴 혼잡 구간을 한 번에 건너뛴다
+    int freeSlot(int e, int time) {
+        std::vector<int>& next = nextSlots[e];
+        int size = static_cast<int>(next.size());
+        int slot = time;
+        while (slot < size && next[slot] != slot) slot = next[slot];
+        for (int t = time; t < size && next[t] != t;) {
+            int following = next[t];
+            next[t] = slot;
+            t = following;
+        }
+        while (slot >= size && slotCapacity(e, slot) == 0) slot++; // 아직 늘리지 않은 단계
+        return slot;
+    }
+
+    void reserve(int e, int time, int count) {
+        if (time >= static_cast<int>(loads[e].size())) {
+            int size = static_cast<int>(loads[e].size());
+            loads[e].resize(time + 1, 0);
+            nextSlots[e].resize(time + 1);
+            for (int t = size; t <= time; ++t) nextSlots[e][t] = slotCapacity(e, t) > 0 ? t : t + 1;
+        }
+        loads[e][time] += count;
+        if (loads[e][time] >= slotCapacity(e, time)) nextSlots[e][time] = time + 1;
+    }
+
+    // 정해진 경로를 0단계에 출발해 가장 이른 빈 단계마다 간선에 들어선다고 할 때의 도착 시각 (departures에 간선별 출발 단계를 채운다)
+    int schedule(const std::vector<int>& route, std::vector<int>& departures) {
+        departures.clear();
+        int time = 0;
+        for (size_t i = 0; i + 1 < route.size(); ++i) {
+            int e = graph->edge(route[i], route[i + 1]);
+            int depart = freeSlot(e, time);
+            departures.push_back(depart);
+            time = depart + transitSteps[e];
+        }
+        return time;
+    }
+
+    // 남은 인원이 있는 모든 노드에서 동시에 출발하는 시간 의존 다익스트라 (가장 일찍 도착하는 탈출구까지의 경로를 route에 채운다)
+    // 노드에서 기다릴 수 있으므로 노드별로 가장 이른 도착 시각만 알면 된다
+    int search(const std::vector<int>& occupants, const std::vector<bool>& isExit, std::vector<int>& route) {
+        const int INF = std::numeric_limits<int>::max();
+        int n = graph->size();
+        std::vector<int> arrival(n, INF), previous(n, -1);
+        typedef std::pair<int, int> Entry;
+        std::priority_queue<Entry, std::vector<Entry>, std::greater<Entry>> queue;
+        for (int v = 0; v < n; ++v) {
+            if (occupants[v] > 0) {
+                arrival[v] = 0;
+                queue.push({ 0, v });
+            }
+        }
+
+        int reached = -1;
+        while (!queue.empty()) {
+            Entry top = queue.top();
+            queue.pop();
+            int u = top.second;
+            if (top.first > arrival[u]) continue;
+            if (isExit[u]) {
+                reached = u;
+                break;
+            }
+            for (int e = graph->offsets[u]; e < graph->offsets[u + 1]; ++e) {
+                int v = graph->targets[e];
+                int t = freeSlot(e, arrival[u]) + transitSteps[e];
+                if (t < arrival[v]) {
+                    arrival[v] = t;
+                    previous[v] = u;
+                    queue.push({ t, v });
+                }
+            }
+        }
+        if (reached < 0) return INF;
+
+        route.clear();
+        for (int at = reached; at != -1; at = previous[at]) {
+            route.push_back(at);
+        }
+        std::reverse(route.begin(), route.end());
+        return arrival[reached];
+    }
+
+    const Graph* graph;
+    std::vector<int> transitSteps;  // 간선별 통과 시간 (단계)
+    std::vector<double> capacityPerStep;  // 간선별 단계당 평균 진입 가능 인원
+    std::vector<std::vector<int>> loads;  // 간선별, 시간 단계별 진입 인원 (필요한 단계까지만 늘린다)
+    std::vector<std::vector<int>> nextSlots;  // 간선별, 시간 단계별로 빈 단계를 찾아 따라갈 다음 단계 (비어 있으면 자기 자신)
+};
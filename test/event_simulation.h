@@ -0,0 +1,243 @@
+#pragma once
+
+#include <vector>
+#include <queue>
+#include <cstdint>
+#include <functional>
+#include <utility>
+#include <algorithm>
+
+#include "graph.h"
+#include "node_bitset.h"
+#include "stochastic_fire.h"
+#include "path_index.h"
+
+// 에이전트 상태
+enum class AgentStatus {
+    Moving,  // 경로를 따라 이동 중
+    Escaped,  // 탈출구에 도착
+    NoInitialPath,  // 처음부터 탈출구로 가는 경로가 없음
+    Trapped  // 이동 중 모든 경로가 화재로 막힘
+};
+
+// 경로를 따라 이동하는 에이전트
+struct Agent {
+    std::vector<int> path;  // 현재 경로 (노드 ID)
+    size_t currentPathIndex = 0;  // 마지막으로 출발한 경로 노드의 위치
+    double departTime = 0.0;  // 현재 간선을 출발한 시각
+    int version = 0;  // 경로가 바뀔 때마다 증가 (이전 경로로 예약된 도착 이벤트를 무시하기 위함)
+    AgentStatus status = AgentStatus::Moving;
+    double escapeTime = 0.0;  // 탈출한 시각
+    double totalWeight = 0.0;  // 지나온 간선 가중치의 합
+    int replans = 0;  // 경로 재계산 횟수
+    int burningAhead = 0;  // 남은 경로 중 지나지 않았는데 불타는 노드 수 (0보다 크면 경로가 막힌 것)
+    NodeBitset passedNodes;  // 지나온 노드
+};
+
+// 화재 틱과 에이전트 도착을 이벤트로 처리하는 이산 사건 시뮬레이션
+// 프레임마다 시간을 조금씩 진행하는 대신 다음 이벤트 시각으로 바로 건너뛰므로, 창이 없으면 한 시간짜리 대피도 순식간에 끝난다
+class EventSimulation {
+public:
+    // 현재 화재 상태에서 from -> 탈출구 경로를 찾는 함수 (경로가 없으면 빈 벡터)
+    typedef std::function<std::vector<int>(int from, double now, const NodeBitset& fireNodes)> Planner;
+
+    // travelTimes[e]는 에이전트가 간선 e를 지나는 데 걸리는 시간
+    EventSimulation(const Graph& graph, const std::vector<double>& travelTimes, int exitId, Planner planner)
+        : graph(&graph), travelTimes(travelTimes), exitId(exitId), planner(planner),
+          fireNodes(graph.size()), routes(graph.size()), now(0.0), sequence(0), movingAgents(0), fireModel(nullptr), fireRng(nullptr), fireTick(0.0) {}
+
+    // 확률적 화재: tick초마다 화재 모델로 한 틱씩 확산한다 (이미 불타는 노드도 모델에 반영한다)
+    void useStochasticFire(const StochasticFireModel& model, LaneRandom& rng, double tick) {
+        fireModel = &model;
+        fireRng = &rng;
+        fireTick = tick;
+        burning.assign(graph->size(), 0);
+        fireNodes.forEach([this](int id) { burning[id] = 1; });
+        push(now + tick, EventType::FireTick, -1, 0);
+    }
+
+    // 지금 노드에 불을 붙이는 함수 (최초 발화, 그 뒤의 확산은 화재 모델이 맡는다)
+    void ignite(int node) {
+        std::vector<int> ignited;
+        if (fireNodes.insert(node)) {
+            if (!burning.empty()) burning[node] = 1;
+            ignited.push_back(node);
+        }
+        onIgnited(ignited);
+    }
+
+    // 에이전트를 추가하고 첫 경로를 계획하는 함수 (에이전트 번호를 반환)
+    int addAgent(int startId) {
+        agents.emplace_back();
+        Agent& agent = agents.back();
+        agent.passedNodes = NodeBitset(graph->size());
+        agent.departTime = now;
+        agent.path = planner(startId, now, fireNodes);
+        int id = static_cast<int>(agents.size()) - 1;
+        if (agent.path.empty()) {
+            agent.status = AgentStatus::NoInitialPath;
+        }
+        else if (agent.path.size() == 1) {
+            agent.status = AgentStatus::Escaped;
+            agent.escapeTime = now;
+        }
+        else {
+            movingAgents++;
+            indexRoute(id);
+            scheduleArrival(id);
+        }
+        return id;
+    }
+
+    // 모든 에이전트가 탈출하거나 고립될 때까지, 또는 timeLimit까지 이벤트를 처리하는 함수
+    void runUntil(double timeLimit) {
+        while (!events.empty() && movingAgents > 0 && events.top().time <= timeLimit) {
+            step();
+        }
+    }
+
+    // 다음 이벤트 하나를 처리하는 함수
+    void step() {
+        Event event = events.top();
+        events.pop();
+        now = event.time;
+
+        switch (event.type) {
+        case EventType::FireTick: {
+            std::vector<int> ignited;
+            fireModel->step(burning, *fireRng, ignited);
+            for (int id : ignited) {
+                fireNodes.set(id);
+            }
+            onIgnited(ignited);
+            push(now + fireTick, EventType::FireTick, -1, 0);
+            break;
+        }
+        case EventType::Arrive:
+            onArrive(event.agent, event.version);
+            break;
+        }
+    }
+
+    double time() const { return now; }
+    bool finished() const { return movingAgents == 0; }
+    const NodeBitset& fire() const { return fireNodes; }
+    const std::vector<Agent>& agentList() const { return agents; }
+
+private:
+    // 같은 시각이면 화재 이벤트를 도착 이벤트보다 먼저 처리한다 (게임 화면의 처리 순서와 같음)
+    enum class EventType { FireTick = 0, Arrive = 1 };
+
+    struct Event {
+        double time;
+        EventType type;
+        std::uint64_t sequence;
+        int agent;
+        int version;
+        bool operator>(const Event& other) const {
+            if (time != other.time) return time > other.time;
+            if (type != other.type) return type > other.type;
+            return sequence > other.sequence;
+        }
+    };
+
+    void push(double time, EventType type, int agent, int version) {
+        events.push({ time, type, sequence++, agent, version });
+    }
+
+    // 새로 불붙은 노드가 에이전트의 남은 경로를 막으면 현재 노드에서 경로를 다시 찾는다
+    // 역색인에서 불붙은 노드를 경로에 가진 에이전트만 꺼내 보므로 비용은 새로 불붙은 노드와 그 경로 항목 수에 비례한다
+    void onIgnited(const std::vector<int>& ignited) {
+        if (ignited.empty()) return;
+        // 재계산한 경로가 이미 불타는 노드(서 있는 노드)에서 시작하면 그 노드를 지날 때까지 계속 막힌 상태로 남는다
+        std::vector<int> candidates;
+        candidates.swap(blockedAgents);
+        for (int id : ignited) {
+            routes.take(id, [&](const RouteIndex::Entry& entry) {
+                Agent& agent = agents[entry.agent];
+                if (agent.status != AgentStatus::Moving || agent.version != entry.version) return; // 이전 경로의 항목
+                if (entry.position < static_cast<int>(agent.currentPathIndex) || agent.passedNodes.test(id)) return;
+                if (agent.burningAhead++ == 0) candidates.push_back(entry.agent);
+            });
+        }
+        // 에이전트 번호 순으로 경로를 다시 찾는다 (결과가 처리 순서에 의존하지 않도록)
+        std::sort(candidates.begin(), candidates.end());
+        candidates.erase(std::unique(candidates.begin(), candidates.end()), candidates.end());
+
+        for (int id : candidates) {
+            Agent& agent = agents[id];
+            if (agent.status != AgentStatus::Moving || agent.burningAhead == 0) continue;
+
+            agent.replans++;
+            std::vector<int> newPath = planner(agent.path[agent.currentPathIndex], now, fireNodes);
+            agent.version++;
+            if (newPath.empty()) {
+                agent.status = AgentStatus::Trapped;
+                movingAgents--;
+                continue;
+            }
+            agent.path = newPath;
+            agent.currentPathIndex = 0;
+            agent.departTime = now;
+            indexRoute(id);
+            scheduleArrival(id);
+        }
+    }
+
+    // 에이전트의 현재 경로를 역색인에 넣고, 경로에 이미 불타는 노드가 있는지 센다
+    void indexRoute(int id) {
+        Agent& agent = agents[id];
+        routes.add(id, agent.version, agent.path);
+        agent.burningAhead = 0;
+        for (int node : agent.path) {
+            if (fireNodes.test(node) && !agent.passedNodes.test(node)) agent.burningAhead++;
+        }
+        if (agent.burningAhead > 0) blockedAgents.push_back(id);
+    }
+
+    void onArrive(int id, int version) {
+        Agent& agent = agents[id];
+        if (agent.status != AgentStatus::Moving || agent.version != version) return; // 경로가 바뀌어 무효가 된 이벤트
+
+        int from = agent.path[agent.currentPathIndex];
+        agent.totalWeight += graph->weight(from, agent.path[agent.currentPathIndex + 1]);
+        if (fireNodes.test(from) && !agent.passedNodes.test(from)) agent.burningAhead--; // 불타는 노드를 빠져나감
+        agent.passedNodes.set(from);
+        agent.currentPathIndex++;
+        agent.departTime = now;
+        if (agent.currentPathIndex + 1 >= agent.path.size()) {
+            agent.status = AgentStatus::Escaped;
+            agent.escapeTime = now;
+            movingAgents--;
+            return;
+        }
+        scheduleArrival(id);
+    }
+
+    void scheduleArrival(int id) {
+        const Agent& agent = agents[id];
+        int e = graph->edge(agent.path[agent.currentPathIndex], agent.path[agent.currentPathIndex + 1]);
+        push(agent.departTime + travelTimes[e], EventType::Arrive, id, agent.version);
+    }
+
+    const Graph* graph;
+    std::vector<double> travelTimes;
+    int exitId;
+    Planner planner;
+
+    NodeBitset fireNodes;  // 불타는 노드
+    RouteIndex routes;  // 노드 -> 그 노드를 경로에 가진 에이전트
+    std::vector<int> blockedAgents;  // 경로를 다시 찾은 뒤에도 불타는 노드가 남아 있는 에이전트
+
+    std::priority_queue<Event, std::vector<Event>, std::greater<Event>> events;
+    double now;
+    std::uint64_t sequence;
+
+    std::vector<Agent> agents;
+    int movingAgents;
+
+    const StochasticFireModel* fireModel;  // 확률적 화재 모델 (useStochasticFire 전에는 불이 번지지 않는다)
+    LaneRandom* fireRng;
+    std::vector<std::int32_t> burning;  // 확률적 화재 모델의 노드별 상태
+    double fireTick;
+};
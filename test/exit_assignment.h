@@ -0,0 +1,184 @@
+#pragma once
+
+#include <vector>
+#include <queue>
+#include <limits>
+#include <utility>
+#include <algorithm>
+
+#include "graph.h"
+#include "flow.h"
+
+// 출발 노드에서 한 탈출구로 보내는 인원
+struct ExitFlow {
+    int source;  // 출발 노드
+    int exit;  // 탈출구 (exits의 인덱스)
+    int count;  // 인원
+};
+
+// 탈출구 배정 결과
+struct ExitAssignment {
+    std::vector<ExitFlow> flows;
+    std::vector<int> exitLoads;  // 탈출구별 배정 인원
+    double walkCost = 0.0;  // 모든 인원이 탈출구까지 걷는 시간의 합 (초)
+    double queueCost = 0.0;  // 모든 인원이 탈출구에서 기다리는 시간의 합 (초, k번째로 도착한 사람은 k / 통과율만큼 기다린다)
+    double clearTime = 0.0;  // 가장 붐비는 탈출구가 배정 인원을 모두 내보내는 데 걸리는 시간 (초)
+    int unassigned = 0;  // 어느 탈출구로도 갈 수 없는 인원
+    int augmentations = 0;  // 최소 비용 유량의 증가 경로 수 (가까운 탈출구 배정은 0)
+};
+
+// 탈출구 노드로 들어오는 간선 용량의 합 (탈출구가 초당 내보낼 수 있는 인원)
+inline double exitThroughput(const Graph& graph, const std::vector<double>& capacities, int exit) {
+    double rate = 0.0;
+    for (int slot = graph.reverseOffsets[exit]; slot < graph.reverseOffsets[exit + 1]; ++slot) {
+        rate += capacities[graph.reverseEdges[slot]];
+    }
+    return rate;
+}
+
+// 모든 노드에서 가장 가까운 탈출구까지의 이동 시간과 그 탈출구 (exits의 인덱스, 갈 수 없으면 -1)
+// 탈출구들에서 동시에 출발해 들어오는 간선을 거꾸로 따라가는 다익스트라
+inline std::pair<std::vector<double>, std::vector<int>> nearestExits(const Graph& graph, const std::vector<double>& travelTimes,
+    const std::vector<int>& exits) {
+    const double INF = std::numeric_limits<double>::infinity();
+    std::vector<double> dist(graph.size(), INF);
+    std::vector<int> nearest(graph.size(), -1);
+    typedef std::pair<double, int> Entry;
+    std::priority_queue<Entry, std::vector<Entry>, std::greater<Entry>> queue;
+    for (size_t i = 0; i < exits.size(); ++i) {
+        dist[exits[i]] = 0.0;
+        nearest[exits[i]] = static_cast<int>(i);
+        queue.push({ 0.0, exits[i] });
+    }
+    while (!queue.empty()) {
+        Entry top = queue.top();
+        queue.pop();
+        int v = top.second;
+        if (top.first > dist[v]) continue;
+        for (int slot = graph.reverseOffsets[v]; slot < graph.reverseOffsets[v + 1]; ++slot) {
+            int u = graph.sources[slot];
+            double alt = dist[v] + travelTimes[graph.reverseEdges[slot]];
+            if (alt < dist[u]) {
+                dist[u] = alt;
+                nearest[u] = nearest[v];
+                queue.push({ alt, u });
+            }
+        }
+    }
+    return { dist, nearest };
+}
+
+// 탈출구별 배정 인원으로 대기 시간 합과 탈출구를 비우는 시간을 채우는 함수
+inline void fillQueueCosts(ExitAssignment& assignment, const std::vector<double>& exitRates) {
+    assignment.queueCost = 0.0;
+    assignment.clearTime = 0.0;
+    for (size_t i = 0; i < exitRates.size(); ++i) {
+        double load = assignment.exitLoads[i];
+        if (load == 0.0) continue;
+        assignment.queueCost += load * (load - 1.0) / 2.0 / exitRates[i];
+        assignment.clearTime = std::max(assignment.clearTime, load / exitRates[i]);
+    }
+}
+
+// 모든 인원을 가장 가까운 탈출구로 보내는 배정 (비교 기준: 탈출구의 혼잡은 고려하지 않는다)
+inline ExitAssignment assignNearestExits(const Graph& graph, const std::vector<double>& travelTimes,
+    const std::vector<int>& occupants, const std::vector<int>& exits, const std::vector<double>& exitRates) {
+    std::pair<std::vector<double>, std::vector<int>> nearest = nearestExits(graph, travelTimes, exits);
+    ExitAssignment assignment;
+    assignment.exitLoads.assign(exits.size(), 0);
+    for (int v = 0; v < graph.size(); ++v) {
+        if (occupants[v] == 0) continue;
+        int exit = nearest.second[v];
+        if (exit < 0) {
+            assignment.unassigned += occupants[v];
+            continue;
+        }
+        assignment.flows.push_back({ v, exit, occupants[v] });
+        assignment.exitLoads[exit] += occupants[v];
+        assignment.walkCost += occupants[v] * nearest.first[v];
+    }
+    fillQueueCosts(assignment, exitRates);
+    return assignment;
+}
+
+// 걷는 시간과 탈출구 대기 시간의 합이 최소가 되도록 인원을 탈출구에 배정하는 함수 (최소 비용 유량)
+// 가상 출발점 -> 출발 노드(용량: 인원) -> 그래프 간선(용량 무제한, 비용: 이동 시간) -> 탈출구 -> 가상 도착점으로 네트워크를 만든다.
+// 탈출구에서 기다리는 시간은 인원에 따라 늘어나는 볼록 비용이므로, 탈출구 -> 도착점 간선을 segments개 구간으로 나누어
+// 뒤 구간일수록 그 구간 사람들의 평균 대기 시간만큼 비용을 높인다 (구간은 자연히 앞에서부터 채워진다).
+inline ExitAssignment assignExitsMinCost(const Graph& graph, const std::vector<double>& travelTimes,
+    const std::vector<int>& occupants, const std::vector<int>& exits, const std::vector<double>& exitRates, int segments = 64) {
+    int n = graph.size();
+    int source = n, sink = n + 1;
+    long long total = 0;
+    for (int count : occupants) total += count;
+
+    MinCostFlowNetwork network(n + 2);
+    std::vector<int> sourceEdges(n, -1);
+    for (int v = 0; v < n; ++v) {
+        if (occupants[v] > 0) sourceEdges[v] = network.addEdge(source, v, occupants[v], 0.0);
+    }
+    std::vector<int> graphEdges(graph.targets.size());
+    for (int u = 0; u < n; ++u) {
+        for (int e = graph.offsets[u]; e < graph.offsets[u + 1]; ++e) {
+            graphEdges[e] = network.addEdge(u, graph.targets[e], total, travelTimes[e]);
+        }
+    }
+    long long segmentSize = std::max(1LL, (total + segments - 1) / segments);
+    std::vector<int> exitIndex(n, -1);
+    std::vector<std::vector<int>> sinkEdges(exits.size());
+    for (size_t i = 0; i < exits.size(); ++i) {
+        if (exitIndex[exits[i]] >= 0) continue;
+        exitIndex[exits[i]] = static_cast<int>(i);
+        for (int j = 0; j < segments; ++j) {
+            // j번째 구간의 사람들은 탈출구에 j * segmentSize ~ (j + 1) * segmentSize - 1번째로 도착하므로 평균 대기 시간을 비용으로 쓴다
+            double wait = (j * segmentSize + (segmentSize - 1) / 2.0) / exitRates[i];
+            sinkEdges[i].push_back(network.addEdge(exits[i], sink, segmentSize, wait));
+        }
+    }
+    network.successiveShortestPaths(source, sink, total);
+
+    ExitAssignment assignment;
+    assignment.exitLoads.assign(exits.size(), 0);
+    assignment.augmentations = network.augmentations();
+
+    // 흐름 분해: 출발 노드마다 유량이 남은 간선을 따라가다가, 도착점으로 나가는 유량이 남은 탈출구에서 멈추고
+    // 지나온 간선의 최소 유량만큼을 한 묶음으로 뗀다 (모든 이동 비용이 양수이므로 최적 유량에는 순환이 없다)
+    std::vector<long long> remaining(graph.targets.size());
+    for (size_t e = 0; e < remaining.size(); ++e) {
+        remaining[e] = network.flow(graphEdges[e]);
+    }
+    std::vector<long long> exitRemaining(exits.size(), 0);
+    for (size_t i = 0; i < exits.size(); ++i) {
+        for (int e : sinkEdges[i]) exitRemaining[i] += network.flow(e);
+    }
+    std::vector<int> path;
+    for (int v = 0; v < n; ++v) {
+        if (sourceEdges[v] < 0) continue;
+        long long left = network.flow(sourceEdges[v]);
+        assignment.unassigned += static_cast<int>(occupants[v] - left);
+        while (left > 0) {
+            path.clear();
+            long long amount = left;
+            int at = v;
+            while (exitIndex[at] < 0 || exitRemaining[exitIndex[at]] == 0) {
+                int taken = graph.offsets[at];
+                while (remaining[taken] == 0) taken++;
+                path.push_back(taken);
+                amount = std::min(amount, remaining[taken]);
+                at = graph.targets[taken];
+            }
+            int exit = exitIndex[at];
+            amount = std::min(amount, exitRemaining[exit]);
+            for (int e : path) {
+                remaining[e] -= amount;
+                assignment.walkCost += amount * travelTimes[e];
+            }
+            exitRemaining[exit] -= amount;
+            assignment.flows.push_back({ v, exit, static_cast<int>(amount) });
+            assignment.exitLoads[exit] += static_cast<int>(amount);
+            left -= amount;
+        }
+    }
+    fillQueueCosts(assignment, exitRates);
+    return assignment;
+}
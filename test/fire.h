@@ -0,0 +1,96 @@
+#pragma once
+
+#include <vector>
+#include <queue>
+#include <limits>
+#include <functional>
+#include <utility>
+#include <algorithm>
+
+#include "graph.h"
+
+// 발화 지점에서 각 노드에 불이 도달하는 시각을 미리 계산해 둔 화재 도달 시간장
+// 화재 확산은 결정적이므로 발화 시나리오마다 다중 출발점 다익스트라 한 번으로 전체 확산 과정을 알 수 있다
+class FireField {
+public:
+    // spreadTime(e)는 간선 e를 따라 불이 번지는 데 걸리는 시간
+    template <typename SpreadTimeFn>
+    FireField(const Graph& graph, const std::vector<int>& ignitions, SpreadTimeFn spreadTime)
+        : arrivals(graph.size(), std::numeric_limits<double>::infinity()), cursor(0) {
+        typedef std::pair<double, int> Entry;
+        std::priority_queue<Entry, std::vector<Entry>, std::greater<Entry>> queue;
+        for (int id : ignitions) {
+            arrivals[id] = 0.0;
+            queue.push({ 0.0, id });
+        }
+
+        while (!queue.empty()) {
+            Entry top = queue.top();
+            queue.pop();
+            int u = top.second;
+            if (top.first > arrivals[u]) continue;
+            order.push_back(u);
+
+            for (int e = graph.offsets[u]; e < graph.offsets[u + 1]; ++e) {
+                int v = graph.targets[e];
+                double alt = arrivals[u] + spreadTime(e);
+                if (alt < arrivals[v]) {
+                    arrivals[v] = alt;
+                    queue.push({ alt, v });
+                }
+            }
+        }
+    }
+
+    // time 시각에 nodes에도 불이 붙는 것으로 도달 시각을 다시 계산하는 함수 (이미 그보다 먼저 불이 도달하는 노드는 그대로)
+    // time은 마지막 ignite 시각 이후여야 하며, 아직 불붙지 않은 노드의 순서만 다시 정렬하므로 ignite로 이미 돌려준 노드는 바뀌지 않는다
+    template <typename SpreadTimeFn>
+    void addIgnitions(const Graph& graph, const std::vector<int>& nodes, double time, SpreadTimeFn spreadTime) {
+        const double INF = std::numeric_limits<double>::infinity();
+        typedef std::pair<double, int> Entry;
+        std::priority_queue<Entry, std::vector<Entry>, std::greater<Entry>> queue;
+        for (int id : nodes) {
+            if (time < arrivals[id]) {
+                if (arrivals[id] == INF) order.push_back(id);
+                arrivals[id] = time;
+                queue.push({ time, id });
+            }
+        }
+
+        while (!queue.empty()) {
+            Entry top = queue.top();
+            queue.pop();
+            int u = top.second;
+            if (top.first > arrivals[u]) continue;
+
+            for (int e = graph.offsets[u]; e < graph.offsets[u + 1]; ++e) {
+                int v = graph.targets[e];
+                double alt = arrivals[u] + spreadTime(e);
+                if (alt < arrivals[v]) {
+                    if (arrivals[v] == INF) order.push_back(v); // 원래는 불이 닿지 않던 노드
+                    arrivals[v] = alt;
+                    queue.push({ alt, v });
+                }
+            }
+        }
+        std::stable_sort(order.begin() + cursor, order.end(), [this](int a, int b) { return arrivals[a] < arrivals[b]; });
+    }
+
+    // 노드에 불이 도달하는 시각 (도달하지 않으면 무한대)
+    double arrival(int id) const { return arrivals[id]; }
+
+    // 주어진 시각까지 새로 불붙은 노드들을 반환하는 함수 (이전 호출 이후에 불붙은 노드만)
+    // 도달 시각 순으로 정렬된 목록의 커서만 옮기므로 비용은 새로 불붙은 노드 수에 비례한다
+    std::vector<int> ignite(double time) {
+        std::vector<int> ignited;
+        while (cursor < order.size() && arrivals[order[cursor]] <= time) {
+            ignited.push_back(order[cursor++]);
+        }
+        return ignited;
+    }
+
+private:
+    std::vector<double> arrivals;  // 노드 ID별 화재 도달 시각
+    std::vector<int> order;  // 불이 도달하는 순서대로 정렬된 노드 ID
+    size_t cursor;  // 지금까지 불붙은 노드 수
+};
@@ -0,0 +1,52 @@
+#pragma once
+
+#include <vector>
+#include <cstddef>
+
+// 불이 간선을 따라 번지는 애니메이션들을 모아 둔 저장소
+// 애니메이션마다 노드 ID와 진행률만 배열(SoA)로 저장하고, 끝난 애니메이션은 마지막 원소와 자리를 바꿔 지운다.
+// 따라서 진행 중인 애니메이션 수에만 비례하는 비용으로 갱신/그리기를 할 수 있고, 지운 자리는 다음 애니메이션이 재사용한다.
+class FireAnimationPool {
+public:
+    // from -> to 간선을 duration초에 걸쳐 건너는 애니메이션 추가
+    void add(int from, int to, float duration) {
+        sources.push_back(from);
+        targets.push_back(to);
+        progresses.push_back(0.0f);
+        rates.push_back(1.0f / duration);
+    }
+
+    // 모든 애니메이션을 dt초만큼 진행하고, 도착한 애니메이션은 onArrive(도착 노드 ID)를 호출한 뒤 지우는 함수
+    template <typename ArriveFn>
+    void update(float dt, ArriveFn onArrive) {
+        size_t i = 0;
+        while (i < sources.size()) {
+            progresses[i] += dt * rates[i];
+            if (progresses[i] < 1.0f) {
+                ++i;
+                continue;
+            }
+            onArrive(targets[i]);
+            // 마지막 애니메이션을 이 자리로 옮기고, 옮겨 온 애니메이션도 이번 프레임에 진행시키기 위해 i는 그대로 둔다
+            sources[i] = sources.back();
+            targets[i] = targets.back();
+            progresses[i] = progresses.back();
+            rates[i] = rates.back();
+            sources.pop_back();
+            targets.pop_back();
+            progresses.pop_back();
+            rates.pop_back();
+        }
+    }
+
+    size_t size() const { return sources.size(); }
+    int source(size_t i) const { return sources[i]; }
+    int target(size_t i) const { return targets[i]; }
+    float progress(size_t i) const { return progresses[i]; }
+
+private:
+    std::vector<int> sources;  // 불이 출발한 노드 ID
+    std::vector<int> targets;  // 불이 향하는 노드 ID
+    std::vector<float> progresses;  // 진행률 (0 ~ 1)
+    std::vector<float> rates;  // 초당 진행률 (1 / 이동 시간)
+};
@@ -0,0 +1,400 @@
+#pragma once
+
+#include <vector>
+#include <string>
+#include <queue>
+#include <limits>
+#include <utility>
+#include <algorithm>
+
+#include "graph.h"
+
+// 간선 종류별 기본 용량 (초당 통과 인원, CSV에 용량이 없는 간선에 쓴다)
+struct CapacityConfig {
+    double road = 5.0;  // 도로 노드('R'로 시작)끼리 잇는 간선
+    double door = 1.5;  // 건물 노드와 도로, 또는 건물 노드끼리 잇는 간선 (출입구)
+    double interior = 10.0;  // 중앙 노드와 건물 노드를 잇는 건물 내부 간선
+};
+
+// 간선별 용량을 만드는 함수 (buildGraph와 같은 순서로 간선을 훑는다)
+// 노드의 capacities[i]가 양수이면 i번째 인접 간선의 용량으로 쓰고, 없으면 간선 종류별 기본 용량을 쓴다
+template <typename NodeT>
+std::vector<double> edgeCapacities(const Graph& graph, const std::vector<NodeT>& nodes, const CapacityConfig& config) {
+    std::vector<double> capacities;
+    capacities.reserve(graph.targets.size());
+    for (size_t u = 0; u < nodes.size(); ++u) {
+        for (size_t i = 0; i < nodes[u].nearNodes.size(); ++i) {
+            int v = graph.id(nodes[u].nearNodes[i].first);
+            if (v < 0) continue;
+            if (i < nodes[u].capacities.size() && nodes[u].capacities[i] > 0.0) {
+                capacities.push_back(nodes[u].capacities[i]);
+            }
+            else if (nodes[u].centralNode == "O" || nodes[v].centralNode == "O") {
+                capacities.push_back(config.interior);
+            }
+            else if (graph.codes[u][0] == 'R' && graph.codes[v][0] == 'R') {
+                capacities.push_back(config.road);
+            }
+            else {
+                capacities.push_back(config.door);
+            }
+        }
+    }
+    return capacities;
+}
+
+// 최대 유량을 구하기 위한 잔여 네트워크
+// 간선 e와 그 역간선 e ^ 1을 짝으로 저장하고, 노드별 간선 목록은 CSR 형식으로 만든다
+class FlowNetwork {
+public:
+    explicit FlowNetwork(int nodeCount) : nodeCount(nodeCount), built(false) {}
+
+    // from -> to 간선을 추가하고 번호를 반환하는 함수 (역간선은 번호 + 1)
+    int addEdge(int from, int to, double capacity) {
+        int e = static_cast<int>(heads.size());
+        heads.push_back(to);
+        capacities.push_back(capacity);
+        heads.push_back(from);
+        capacities.push_back(0.0);
+        built = false;
+        return e;
+    }
+
+    int size() const { return nodeCount; }
+    int from(int e) const { return heads[e ^ 1]; }
+    int to(int e) const { return heads[e]; }
+    double capacity(int e) const { return capacities[e]; }
+    double flow(int e) const { return flows.empty() ? 0.0 : flows[e]; }
+
+    // 기준 알고리즘: 잔여 용량이 있는 최단(간선 수) 증가 경로를 BFS로 찾아 반복해서 흘린다 (O(VE^2))
+    double edmondsKarp(int source, int sink) {
+        prepare();
+        double total = 0.0;
+        std::vector<int> parentEdge(nodeCount);
+        while (true) {
+            std::fill(parentEdge.begin(), parentEdge.end(), -1);
+            std::queue<int> queue;
+            queue.push(source);
+            while (!queue.empty() && parentEdge[sink] < 0) {
+                int u = queue.front();
+                queue.pop();
+                for (int i = offsets[u]; i < offsets[u + 1]; ++i) {
+                    int e = edges[i];
+                    int v = heads[e];
+                    if (v == source || parentEdge[v] >= 0 || residual(e) <= EPS) continue;
+                    parentEdge[v] = e;
+                    queue.push(v);
+                }
+            }
+            if (parentEdge[sink] < 0) break;
+
+            double pushed = std::numeric_limits<double>::infinity();
+            for (int v = sink; v != source; v = heads[parentEdge[v] ^ 1]) {
+                pushed = std::min(pushed, residual(parentEdge[v]));
+            }
+            for (int v = sink; v != source; v = heads[parentEdge[v] ^ 1]) {
+                augment(parentEdge[v], pushed);
+            }
+            total += pushed;
+        }
+        return total;
+    }
+
+    // 실사용 알고리즘: BFS로 레벨 그래프를 만들고 막힘 유량(blocking flow)을 DFS로 흘린다 (O(V^2 E))
+    // 재귀 대신 명시적 스택을 쓰고, 노드별 현재 간선(current arc)을 기억해 이미 막힌 간선을 다시 보지 않는다
+    double dinic(int source, int sink) {
+        prepare();
+        double total = 0.0;
+        std::vector<int> level(nodeCount), arc(nodeCount), stack;
+        while (buildLevels(source, sink, level)) {
+            for (int u = 0; u < nodeCount; ++u) arc[u] = offsets[u];
+            stack.clear(); // source에서 현재 노드까지의 간선
+            int u = source;
+            while (true) {
+                if (u == sink) {
+                    // 경로의 병목만큼 흘리고, 포화된 첫 간선의 출발 노드로 돌아간다
+                    double pushed = std::numeric_limits<double>::infinity();
+                    for (int e : stack) pushed = std::min(pushed, residual(e));
+                    size_t saturated = stack.size();
+                    for (size_t i = 0; i < stack.size(); ++i) {
+                        augment(stack[i], pushed);
+                        if (saturated == stack.size() && residual(stack[i]) <= EPS) saturated = i;
+                    }
+                    total += pushed;
+                    stack.resize(saturated);
+                    u = stack.empty() ? source : heads[stack.back()];
+                    continue;
+                }
+
+                // 레벨이 하나 높고 잔여 용량이 있는 간선을 찾는다
+                while (arc[u] < offsets[u + 1]) {
+                    int e = edges[arc[u]];
+                    if (level[heads[e]] == level[u] + 1 && residual(e) > EPS) break;
+                    arc[u]++;
+                }
+                if (arc[u] < offsets[u + 1]) {
+                    int e = edges[arc[u]];
+                    stack.push_back(e);
+                    u = heads[e];
+                    continue;
+                }
+
+                // 막다른 노드: 레벨 그래프에서 빼고 한 단계 되돌아간다
+                if (u == source) break;
+                level[u] = -1;
+                int back = stack.back();
+                stack.pop_back();
+                u = heads[back ^ 1];
+                arc[u]++;
+            }
+        }
+        return total;
+    }
+
+    // 최대 유량을 구한 뒤, source에서 잔여 간선으로 도달할 수 있는 노드 집합 (최소 컷의 source 쪽)
+    std::vector<bool> sourceSide(int source) const {
+        std::vector<bool> reachable(nodeCount, false);
+        std::queue<int> queue;
+        reachable[source] = true;
+        queue.push(source);
+        while (!queue.empty()) {
+            int u = queue.front();
+            queue.pop();
+            for (int i = offsets[u]; i < offsets[u + 1]; ++i) {
+                int e = edges[i];
+                if (!reachable[heads[e]] && residual(e) > EPS) {
+                    reachable[heads[e]] = true;
+                    queue.push(heads[e]);
+                }
+            }
+        }
+        return reachable;
+    }
+
+private:
+    static constexpr double EPS = 1e-9;
+
+    double residual(int e) const { return capacities[e] - flows[e]; }
+
+    void augment(int e, double amount) {
+        flows[e] += amount;
+        flows[e ^ 1] -= amount;
+    }
+
+    // 간선 목록을 CSR로 정리하고 유량을 0으로 초기화하는 함수
+    void prepare() {
+        flows.assign(heads.size(), 0.0);
+        if (built) return;
+        offsets.assign(nodeCount + 1, 0);
+        for (size_t e = 0; e < heads.size(); ++e) {
+            offsets[heads[e ^ 1] + 1]++;
+        }
+        for (int u = 0; u < nodeCount; ++u) {
+            offsets[u + 1] += offsets[u];
+        }
+        edges.resize(heads.size());
+        std::vector<int> fill(offsets.begin(), offsets.end() - 1);
+        for (size_t e = 0; e < heads.size(); ++e) {
+            edges[fill[heads[e ^ 1]]++] = static_cast<int>(e);
+        }
+        built = true;
+    }
+
+    // source에서 BFS로 레벨을 매기는 함수 (sink에 도달하지 못하면 false)
+    bool buildLevels(int source, int sink, std::vector<int>& level) const {
+        std::fill(level.begin(), level.end(), -1);
+        std::queue<int> queue;
+        level[source] = 0;
+        queue.push(source);
+        while (!queue.empty()) {
+            int u = queue.front();
+            queue.pop();
+            for (int i = offsets[u]; i < offsets[u + 1]; ++i) {
+                int e = edges[i];
+                if (level[heads[e]] < 0 && residual(e) > EPS) {
+                    level[heads[e]] = level[u] + 1;
+                    queue.push(heads[e]);
+                }
+            }
+        }
+        return level[sink] >= 0;
+    }
+
+    int nodeCount;
+    std::vector<int> heads;  // 간선의 도착 노드 (e ^ 1의 도착 노드가 e의 출발 노드)
+    std::vector<double> capacities;  // 간선 용량 (역간선은 0)
+    std::vector<double> flows;  // 간선 유량 (역간선은 음수)
+    std::vector<int> offsets;  // 노드 u에서 나가는 간선은 edges[offsets[u] .. offsets[u + 1])
+    std::vector<int> edges;  // 출발 노드 순으로 정렬한 간선 번호
+    bool built;
+};
+
+// 최소 비용 유량을 구하기 위한 잔여 네트워크 (FlowNetwork와 같이 간선 e와 역간선 e ^ 1을 짝으로 저장하고 CSR로 훑는다)
+// 용량은 인원 수(정수), 비용은 한 명이 간선을 지날 때의 비용이며 0 이상이어야 한다
+class MinCostFlowNetwork {
+public:
+    explicit MinCostFlowNetwork(int nodeCount) : nodeCount(nodeCount), built(false), augmentationCount(0) {}
+
+    // from -> to 간선을 추가하고 번호를 반환하는 함수 (역간선은 번호 + 1, 비용은 -cost)
+    int addEdge(int from, int to, long long capacity, double cost) {
+        int e = static_cast<int>(heads.size());
+        heads.push_back(to);
+        capacities.push_back(capacity);
+        costs.push_back(cost);
+        heads.push_back(from);
+        capacities.push_back(0);
+        costs.push_back(-cost);
+        built = false;
+        return e;
+    }
+
+    int size() const { return nodeCount; }
+    int from(int e) const { return heads[e ^ 1]; }
+    int to(int e) const { return heads[e]; }
+    long long capacity(int e) const { return capacities[e]; }
+    double cost(int e) const { return costs[e]; }
+    long long flow(int e) const { return flows.empty() ? 0 : flows[e]; }
+    int augmentations() const { return augmentationCount; }
+
+    // 순차 최단 경로(successive shortest paths): source에서 sink로 limit만큼(또는 더 흘릴 수 없을 때까지) 흘리고 (유량, 총 비용)을 반환
+    // 노드별 잠재 함수(potential)로 줄인 비용(reduced cost)이 음수가 되지 않게 유지하므로, 역간선이 생겨도 매번 다익스트라로 최단 증가 경로를 찾는다
+    std::pair<long long, double> successiveShortestPaths(int source, int sink, long long limit) {
+        const double INF = std::numeric_limits<double>::infinity();
+        prepare();
+        augmentationCount = 0;
+        std::vector<double> potential(nodeCount, 0.0), dist(nodeCount);
+        std::vector<int> parentEdge(nodeCount);
+        std::vector<bool> done(nodeCount);
+        typedef std::pair<double, int> Entry;
+        long long total = 0;
+        double totalCost = 0.0;
+
+        while (total < limit) {
+            std::fill(dist.begin(), dist.end(), INF);
+            std::fill(parentEdge.begin(), parentEdge.end(), -1);
+            std::fill(done.begin(), done.end(), false);
+            std::priority_queue<Entry, std::vector<Entry>, std::greater<Entry>> queue;
+            dist[source] = 0.0;
+            queue.push({ 0.0, source });
+            while (!queue.empty()) {
+                int u = queue.top().second;
+                queue.pop();
+                if (done[u]) continue;
+                done[u] = true;
+                if (u == sink) break; // sink보다 먼 노드는 이번 경로에 필요 없다
+                for (int i = offsets[u]; i < offsets[u + 1]; ++i) {
+                    int e = edges[i];
+                    int v = heads[e];
+                    if (done[v] || capacities[e] - flows[e] <= 0) continue;
+                    // 반올림 오차로 생기는 아주 작은 음수는 0으로 본다
+                    double alt = dist[u] + std::max(0.0, costs[e] + potential[u] - potential[v]);
+                    if (alt < dist[v]) {
+                        dist[v] = alt;
+                        parentEdge[v] = e;
+                        queue.push({ alt, v });
+                    }
+                }
+            }
+            if (!done[sink]) break;
+
+            // sink보다 멀거나 도달하지 못한 노드는 sink까지의 거리만큼만 올려야 줄인 비용이 음수가 되지 않는다
+            for (int v = 0; v < nodeCount; ++v) {
+                potential[v] += std::min(dist[v], dist[sink]);
+            }
+
+            long long pushed = limit - total;
+            for (int v = sink; v != source; v = heads[parentEdge[v] ^ 1]) {
+                pushed = std::min(pushed, capacities[parentEdge[v]] - flows[parentEdge[v]]);
+            }
+            for (int v = sink; v != source; v = heads[parentEdge[v] ^ 1]) {
+                flows[parentEdge[v]] += pushed;
+                flows[parentEdge[v] ^ 1] -= pushed;
+                totalCost += pushed * costs[parentEdge[v]];
+            }
+            total += pushed;
+            augmentationCount++;
+        }
+        return { total, totalCost };
+    }
+
+private:
+    // 간선 목록을 CSR로 정리하고 유량을 0으로 초기화하는 함수
+    void prepare() {
+        flows.assign(heads.size(), 0);
+        if (built) return;
+        offsets.assign(nodeCount + 1, 0);
+        for (size_t e = 0; e < heads.size(); ++e) {
+            offsets[heads[e ^ 1] + 1]++;
+        }
+        for (int u = 0; u < nodeCount; ++u) {
+            offsets[u + 1] += offsets[u];
+        }
+        edges.resize(heads.size());
+        std::vector<int> fill(offsets.begin(), offsets.end() - 1);
+        for (size_t e = 0; e < heads.size(); ++e) {
+            edges[fill[heads[e ^ 1]]++] = static_cast<int>(e);
+        }
+        built = true;
+    }
+
+    int nodeCount;
+    std::vector<int> heads;  // 간선의 도착 노드 (e ^ 1의 도착 노드가 e의 출발 노드)
+    std::vector<long long> capacities;  // 간선 용량 (역간선은 0)
+    std::vector<double> costs;  // 한 명당 비용 (역간선은 음수)
+    std::vector<long long> flows;  // 간선 유량 (역간선은 음수)
+    std::vector<int> offsets;  // 노드 u에서 나가는 간선은 edges[offsets[u] .. offsets[u + 1])
+    std::vector<int> edges;  // 출발 노드 순으로 정렬한 간선 번호
+    bool built;
+    int augmentationCount;  // 마지막 실행의 증가 경로 수 (다익스트라 실행 횟수)
+};
+
+// 최대 유량 알고리즘 종류
+enum class FlowEngine {
+    EdmondsKarp,
+    Dinic
+};
+
+// 대피 용량 분석 결과
+struct EvacuationCapacity {
+    double throughput;  // 거주 노드들에서 탈출구들로 초당 내보낼 수 있는 최대 인원
+    std::vector<std::pair<int, int>> bottlenecks;  // 최소 컷을 이루는 (출발 노드, 그래프 간선 번호) (용량이 작은 순)
+};
+
+// 거주 노드들(occupied)에서 탈출구들(exits)로의 최대 대피 유량과 병목 통로(최소 컷)를 구하는 함수
+// 가상 출발점 -> 거주 노드, 탈출구 -> 가상 도착점 간선은 용량 무한대로 두고, 그래프 간선은 capacities를 용량으로 쓴다
+inline EvacuationCapacity analyzeEvacuation(const Graph& graph, const std::vector<double>& capacities,
+    const std::vector<int>& occupied, const std::vector<int>& exits, FlowEngine engine) {
+    const double INF = std::numeric_limits<double>::infinity();
+    int n = graph.size();
+    int source = n, sink = n + 1;
+    FlowNetwork network(n + 2);
+
+    for (int u = 0; u < n; ++u) {
+        for (int e = graph.offsets[u]; e < graph.offsets[u + 1]; ++e) {
+            network.addEdge(u, graph.targets[e], capacities[e]);
+        }
+    }
+    std::vector<bool> isExit(n, false);
+    for (int exitId : exits) {
+        isExit[exitId] = true;
+        network.addEdge(exitId, sink, INF);
+    }
+    for (int id : occupied) {
+        if (!isExit[id]) network.addEdge(source, id, INF); // 탈출구에 있는 인원은 병목 없이 바로 나간다
+    }
+
+    EvacuationCapacity result;
+    result.throughput = engine == FlowEngine::Dinic ? network.dinic(source, sink) : network.edmondsKarp(source, sink);
+
+    std::vector<bool> reachable = network.sourceSide(source);
+    for (int u = 0; u < n; ++u) {
+        if (!reachable[u]) continue;
+        for (int e = graph.offsets[u]; e < graph.offsets[u + 1]; ++e) {
+            if (!reachable[graph.targets[e]]) result.bottlenecks.push_back({ u, e });
+        }
+    }
+    std::sort(result.bottlenecks.begin(), result.bottlenecks.end(), [&](const std::pair<int, int>& a, const std::pair<int, int>& b) {
+        return capacities[a.second] < capacities[b.second];
+    });
+    return result;
+}
@@ -0,0 +1,98 @@
+#pragma once
+
+#include <string>
+#include <vector>
+#include <unordered_map>
+
+// CSR(Compressed Sparse Row) 형식의 그래프
+// 노드 코드를 0 ~ n-1 의 정수 ID로 바꾸고, 각 노드의 인접 간선을 연속된 배열에 저장한다
+struct Graph {
+    std::vector<std::string> codes;  // 노드 ID -> 노드 코드
+    std::unordered_map<std::string, int> ids;  // 노드 코드 -> 노드 ID
+    std::vector<double> latitudes;  // 노드 ID별 위도
+    std::vector<double> longitudes;  // 노드 ID별 경도
+
+    std::vector<int> offsets;  // 노드 u에서 나가는 간선은 [offsets[u], offsets[u + 1]) 구간
+    std::vector<int> targets;  // 간선의 도착 노드 ID
+    std::vector<double> weights;  // 간선의 가중치
+
+    std::vector<int> reverseOffsets;  // 노드 v로 들어오는 간선은 [reverseOffsets[v], reverseOffsets[v + 1]) 구간
+    std::vector<int> sources;  // 들어오는 간선의 출발 노드 ID
+    std::vector<double> reverseWeights;  // 들어오는 간선의 가중치
+    std::vector<int> reverseEdges;  // 들어오는 간선에 해당하는 나가는 간선의 번호
+
+    int size() const { return static_cast<int>(codes.size()); }
+
+    // 노드 코드에 해당하는 ID를 반환 (없으면 -1)
+    int id(const std::string& code) const {
+        auto it = ids.find(code);
+        return it == ids.end() ? -1 : it->second;
+    }
+
+    // from -> to 간선의 번호를 반환 (간선이 없으면 -1)
+    int edge(int from, int to) const {
+        for (int e = offsets[from]; e < offsets[from + 1]; ++e) {
+            if (targets[e] == to) return e;
+        }
+        return -1;
+    }
+
+    // from -> to 간선의 가중치를 반환 (간선이 없으면 -1)
+    double weight(int from, int to) const {
+        int e = edge(from, to);
+        return e < 0 ? -1.0 : weights[e];
+    }
+};
+
+// code, latitude, longitude, nearNodes 멤버를 가진 노드 목록으로 CSR 그래프를 만드는 함수
+// 존재하지 않는 노드를 가리키는 간선은 건너뛴다
+template <typename NodeT>
+Graph buildGraph(const std::vector<NodeT>& nodes) {
+    Graph graph;
+    int n = static_cast<int>(nodes.size());
+    graph.codes.reserve(n);
+    graph.latitudes.reserve(n);
+    graph.longitudes.reserve(n);
+    for (int i = 0; i < n; ++i) {
+        graph.codes.push_back(nodes[i].code);
+        graph.latitudes.push_back(nodes[i].latitude);
+        graph.longitudes.push_back(nodes[i].longitude);
+        graph.ids[nodes[i].code] = i;
+    }
+
+    // 나가는 간선 배열 채우기
+    graph.offsets.assign(n + 1, 0);
+    for (int u = 0; u < n; ++u) {
+        for (const auto& neighbor : nodes[u].nearNodes) {
+            int v = graph.id(neighbor.first);
+            if (v < 0) continue;
+            graph.targets.push_back(v);
+            graph.weights.push_back(neighbor.second);
+        }
+        graph.offsets[u + 1] = static_cast<int>(graph.targets.size());
+    }
+
+    // 들어오는 간선 배열 채우기 (도착 노드별 개수를 센 뒤 누적합으로 위치를 정한다)
+    int m = static_cast<int>(graph.targets.size());
+    graph.reverseOffsets.assign(n + 1, 0);
+    for (int e = 0; e < m; ++e) {
+        graph.reverseOffsets[graph.targets[e] + 1]++;
+    }
+    for (int v = 0; v < n; ++v) {
+        graph.reverseOffsets[v + 1] += graph.reverseOffsets[v];
+    }
+    graph.sources.resize(m);
+    graph.reverseWeights.resize(m);
+    graph.reverseEdges.resize(m);
+    std::vector<int> fill(graph.reverseOffsets.begin(), graph.reverseOffsets.end() - 1);
+    for (int u = 0; u < n; ++u) {
+        for (int e = graph.offsets[u]; e < graph.offsets[u + 1]; ++e) {
+            int slot = fill[graph.targets[e]]++;
+            graph.sources[slot] = u;
+            graph.reverseWeights[slot] = graph.weights[e];
+            graph.reverseEdges[slot] = e;
+        }
+    }
+
+    return graph;
+}
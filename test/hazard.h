@@ -0,0 +1,74 @@
+#pragma once
+
+#include <vector>
+#include <cmath>
+#include <algorithm>
+
+#include "graph.h"
+#include "node_bitset.h"
+#include "dynamic_sssp.h"
+
+// 연기/열 위험 설정
+struct SmokeConfig {
+    double tick = 3.0;  // 연기 갱신 주기 (초)
+    double emission = 1.0;  // 불타는 노드에서 초당 발생하는 연기량
+    double spread = 0.05;  // 초당 연기가 이웃 노드로 퍼져 나가는 비율
+    double decay = 0.01;  // 초당 연기가 자연히 빠지는 비율
+    double costPerSmoke = 0.5;  // 양 끝 노드의 평균 연기량 1당 간선 비용이 늘어나는 비율
+    double minChange = 0.05;  // 비용이 이 비율 이상 변한 간선만 경로 트리에 반영한다
+};
+
+// 불타는 노드 주변에 쌓이는 연기와 그에 따른 간선 비용
+// 불타는지 아닌지만 보는 대신, 연기가 짙은 간선일수록 비용을 높여 경로가 연기를 피해 가도록 한다
+// 틱마다 모든 노드의 연기량을 한꺼번에 갱신하고, 비용이 충분히 변한 간선만 모아 ExitTree에 한 번에 넘긴다
+class SmokeField {
+public:
+    SmokeField(const Graph& graph, const SmokeConfig& config)
+        : graph(&graph), config(config), smoke(graph.size(), 0.0), nextSmoke(graph.size(), 0.0),
+          reportedCosts(graph.weights) {}
+
+    // 한 틱만큼 연기를 발생/확산/감소시키고, 비용이 바뀐 간선을 changes에 채우는 함수
+    void step(const NodeBitset& fireNodes, std::vector<EdgeCostChange>& changes) {
+        const Graph& g = *graph;
+        double dt = config.tick;
+        double outflow = std::min(1.0, config.spread * dt);  // 한 틱 동안 이웃으로 나가는 비율
+        double remain = std::max(0.0, 1.0 - outflow - config.decay * dt);  // 한 틱 뒤에 남는 비율
+
+        for (int v = 0; v < g.size(); ++v) {
+            double amount = smoke[v] * remain;
+            if (fireNodes.test(v)) amount += config.emission * dt;
+            // 들어오는 간선의 출발 노드에서 나가는 연기를 나가는 간선 수로 나눠 받는다
+            for (int e = g.reverseOffsets[v]; e < g.reverseOffsets[v + 1]; ++e) {
+                int u = g.sources[e];
+                amount += smoke[u] * outflow / (g.offsets[u + 1] - g.offsets[u]);
+            }
+            nextSmoke[v] = amount;
+        }
+        smoke.swap(nextSmoke);
+
+        changes.clear();
+        for (int u = 0; u < g.size(); ++u) {
+            for (int e = g.offsets[u]; e < g.offsets[u + 1]; ++e) {
+                double cost = g.weights[e] * (1.0 + config.costPerSmoke * 0.5 * (smoke[u] + smoke[g.targets[e]]));
+                if (std::fabs(cost - reportedCosts[e]) > config.minChange * reportedCosts[e]) {
+                    reportedCosts[e] = cost;
+                    changes.push_back({ u, e, cost });
+                }
+            }
+        }
+    }
+
+    // 노드의 현재 연기량
+    double level(int id) const { return smoke[id]; }
+
+    // 마지막으로 반영한 간선 비용
+    double cost(int e) const { return reportedCosts[e]; }
+    const std::vector<double>& costs() const { return reportedCosts; }
+
+private:
+    const Graph* graph;
+    SmokeConfig config;
+    std::vector<double> smoke;  // 노드 ID별 연기량
+    std::vector<double> nextSmoke;  // 다음 틱의 연기량 (갱신용 버퍼)
+    std::vector<double> reportedCosts;  // 간선별로 마지막으로 반영한 비용
+};
@@ -0,0 +1,245 @@
+#pragma once
+
+#include <vector>
+#include <queue>
+#include <limits>
+#include <functional>
+#include <utility>
+#include <algorithm>
+#include <memory>
+#include <atomic>
+#include <thread>
+
+#include "graph.h"
+#include "node_bitset.h"
+#include "thread_pool.h"
+
+// 노드 ID 경로와 그 총 가중치
+struct RoutePath {
+    std::vector<int> nodes;
+    double cost;
+};
+
+// 특정 노드/간선을 제외한 그래프에서 다익스트라로 최단 경로를 찾는 함수 (Yen 알고리즘의 spur 탐색용)
+// blockedNode[v] == stamp 인 노드와 blockedEdge[e] == stamp 인 간선은 사용하지 않는다
+inline bool restrictedDijkstra(const Graph& graph, int start, int exitId,
+    const std::vector<int>& blockedNode, const std::vector<int>& blockedEdge, int stamp,
+    std::vector<double>& dist, std::vector<int>& previous, RoutePath& result) {
+    const double INF = std::numeric_limits<double>::infinity();
+    std::fill(dist.begin(), dist.end(), INF);
+    std::fill(previous.begin(), previous.end(), -1);
+
+    typedef std::pair<double, int> Entry;
+    std::priority_queue<Entry, std::vector<Entry>, std::greater<Entry>> queue;
+    dist[start] = 0.0;
+    queue.push({ 0.0, start });
+
+    while (!queue.empty()) {
+        Entry top = queue.top();
+        queue.pop();
+        int u = top.second;
+        if (top.first > dist[u]) continue;
+        if (u == exitId) break;
+
+        for (int e = graph.offsets[u]; e < graph.offsets[u + 1]; ++e) {
+            int v = graph.targets[e];
+            if (blockedEdge[e] == stamp || blockedNode[v] == stamp) continue;
+            double alt = dist[u] + graph.weights[e];
+            if (alt < dist[v]) {
+                dist[v] = alt;
+                previous[v] = u;
+                queue.push({ alt, v });
+            }
+        }
+    }
+
+    if (dist[exitId] == INF) return false;
+    result.nodes.clear();
+    for (int at = exitId; at != -1; at = previous[at]) {
+        result.nodes.push_back(at);
+    }
+    std::reverse(result.nodes.begin(), result.nodes.end());
+    result.cost = dist[exitId];
+    return true;
+}
+
+// Yen 알고리즘으로 start -> exitId 의 k개 최단 단순 경로(같은 노드를 두 번 지나지 않는 경로)를 찾는 함수
+// blocked에 속한 노드(화재 노드)는 지나지 않는다. 시작 노드는 불타고 있어도 출발할 수 있다.
+// 각 후보 경로는 부모 경로에서 갈라진 위치 이후에서만 다시 갈라지도록 하여 중복 탐색을 줄인다 (Lawler 최적화)
+inline std::vector<RoutePath> yenKShortestPaths(const Graph& graph, int start, int exitId, int k, const NodeBitset& blocked) {
+    int n = graph.size();
+    std::vector<RoutePath> found;
+    if (k <= 0 || (blocked.test(exitId) && exitId != start)) return found;
+
+    std::vector<int> blockedNode(n, 0), blockedEdge(graph.targets.size(), 0);
+    std::vector<double> dist(n);
+    std::vector<int> previous(n);
+    int stamp = 1;
+
+    // 화재 노드를 막은 상태로 첫 번째 최단 경로를 구한다
+    auto blockFire = [&]() {
+        blocked.forEach([&](int v) {
+            if (v != start) blockedNode[v] = stamp;
+        });
+    };
+    blockFire();
+    RoutePath first;
+    if (!restrictedDijkstra(graph, start, exitId, blockedNode, blockedEdge, stamp, dist, previous, first)) return found;
+
+    // 후보 경로: (비용, 후보 번호). deviation[i]는 후보 i가 부모 경로에서 갈라진 위치
+    std::vector<RoutePath> candidates;
+    std::vector<size_t> deviation;
+    typedef std::pair<double, int> Entry;
+    std::priority_queue<Entry, std::vector<Entry>, std::greater<Entry>> heap;
+
+    found.push_back(first);
+    std::vector<size_t> foundDeviation(1, 0);
+
+    while (static_cast<int>(found.size()) < k) {
+        const RoutePath& last = found.back();
+        size_t lastDeviation = foundDeviation.back();
+
+        // 마지막으로 찾은 경로의 각 노드를 spur 노드로 삼아 새로운 후보를 만든다
+        for (size_t i = lastDeviation; i + 1 < last.nodes.size(); ++i) {
+            ++stamp;
+            blockFire();
+            int spur = last.nodes[i];
+
+            // 같은 root 경로를 공유하는 기존 경로들이 spur 노드에서 사용한 간선을 막는다
+            for (const auto& path : found) {
+                if (path.nodes.size() > i && std::equal(last.nodes.begin(), last.nodes.begin() + i + 1, path.nodes.begin())) {
+                    int v = path.nodes[i + 1];
+                    for (int e = graph.offsets[spur]; e < graph.offsets[spur + 1]; ++e) {
+                        if (graph.targets[e] == v) blockedEdge[e] = stamp;
+                    }
+                }
+            }
+            // root 경로의 노드는 다시 지나지 않는다
+            double rootCost = 0.0;
+            for (size_t j = 0; j < i; ++j) {
+                blockedNode[last.nodes[j]] = stamp;
+                rootCost += graph.weight(last.nodes[j], last.nodes[j + 1]);
+            }
+
+            RoutePath spurPath;
+            if (!restrictedDijkstra(graph, spur, exitId, blockedNode, blockedEdge, stamp, dist, previous, spurPath)) continue;
+
+            RoutePath candidate;
+            candidate.nodes.assign(last.nodes.begin(), last.nodes.begin() + i);
+            candidate.nodes.insert(candidate.nodes.end(), spurPath.nodes.begin(), spurPath.nodes.end());
+            candidate.cost = rootCost + spurPath.cost;
+
+            bool duplicate = false;
+            for (const auto& other : candidates) {
+                if (other.nodes == candidate.nodes) {
+                    duplicate = true;
+                    break;
+                }
+            }
+            if (duplicate) continue;
+
+            heap.push({ candidate.cost, static_cast<int>(candidates.size()) });
+            candidates.push_back(candidate);
+            deviation.push_back(i);
+        }
+
+        if (heap.empty()) break;
+        int best = heap.top().second;
+        heap.pop();
+        found.push_back(candidates[best]);
+        foundDeviation.push_back(deviation[best]);
+    }
+
+    return found;
+}
+
+// 갈림길 노드마다 탈출구까지의 k개 대체 경로를 미리 계산해 두는 테이블
+// 경로가 화재로 막히면 새로 탐색하지 않고 아직 불타지 않은 대체 경로로 바로 전환한다
+class FallbackRoutes {
+public:
+    // 나가는 간선이 minDegree개 이상인 노드를 갈림길로 보고 대체 경로를 계산하는 함수
+    void precompute(const Graph& graph, int exitId, int k, const NodeBitset& blocked, int minDegree = 3) {
+        TaskGroup group(sharedPool());
+        precompute(graph, exitId, k, blocked, group, minDegree);
+        group.wait();
+    }
+
+    // 갈림길마다의 계산을 낮은 우선순위 작업으로 group에 넣고 바로 돌아오는 함수
+    // group.wait()이 끝나기 전에는 경로를 찾기 전에 awaitNode로 그 노드의 계산이 끝났는지 확인해야 한다
+    // 작업은 호출 시점의 blocked 사본을 쓰므로 호출한 쪽은 그동안 blocked를 바꿔도 된다
+    void precompute(const Graph& graph, int exitId, int k, const NodeBitset& blocked, TaskGroup& group, int minDegree = 3) {
+        routes.assign(graph.size(), std::vector<RoutePath>());
+        build = std::make_shared<Build>(graph, exitId, k, blocked);
+        for (int u = 0; u < graph.size(); ++u) {
+            bool junction = u != exitId && !blocked.test(u) && graph.offsets[u + 1] - graph.offsets[u] >= minDegree;
+            build->states[u].store(junction ? Queued : Done);
+        }
+        for (int u = 0; u < graph.size(); ++u) {
+            if (build->states[u].load() == Done) continue;
+            std::shared_ptr<Build> job = build;
+            std::vector<RoutePath>* slot = &routes[u]; // 노드마다 자기 칸에만 쓰므로 잠글 필요가 없다
+            group.run([job, u, slot]() { computeQueued(*job, u, *slot); }, TaskPriority::Background);
+        }
+    }
+
+    // precompute로 넣은 노드 u의 계산이 끝나도록 하는 함수 (다른 노드의 계산은 기다리지 않는다)
+    // u의 작업이 아직 시작되지 않았으면 현재 스레드에서 바로 계산하고, 다른 스레드가 계산 중이면 그 작업만 기다린다
+    void awaitNode(int u) {
+        if (!build) return;
+        computeQueued(*build, u, routes[u]);
+        while (build->states[u].load() != Done) std::this_thread::yield();
+    }
+
+    // 미리 계산하지 않고 노드 u의 대체 경로만 현재 스레드에서 계산하는 함수 (precompute가 u에 대해 계산했을 경로와 같다)
+    // 시나리오 여러 개를 병렬로 돌릴 때처럼 경로가 막힌 노드에서만 필요할 때 쓴다
+    void computeNode(const Graph& graph, int u, int exitId, int k, const NodeBitset& blocked, int minDegree = 3) {
+        if (routes.empty()) routes.assign(graph.size(), std::vector<RoutePath>());
+        if (u == exitId || blocked.test(u)) return;
+        if (graph.offsets[u + 1] - graph.offsets[u] < minDegree) return;
+        routes[u] = yenKShortestPaths(graph, u, exitId, k, blocked);
+    }
+
+    // 노드에서 출발하는 대체 경로 중 isBurning에 걸리지 않는 첫 번째 경로를 반환 (없으면 nullptr)
+    // 출발 노드는 플레이어가 이미 서 있는 곳이므로 검사하지 않는다
+    template <typename BurningFn>
+    const RoutePath* firstFireFree(int node, BurningFn isBurning) const {
+        if (node >= static_cast<int>(routes.size())) return nullptr;
+        for (const auto& route : routes[node]) {
+            bool burning = false;
+            for (size_t i = 1; i < route.nodes.size(); ++i) {
+                if (isBurning(route.nodes[i])) {
+                    burning = true;
+                    break;
+                }
+            }
+            if (!burning) return &route;
+        }
+        return nullptr;
+    }
+
+private:
+    enum { Queued, Running, Done };  // precompute로 넣은 노드의 계산 상태
+
+    // precompute 작업이 함께 쓰는 입력과 노드별 계산 상태 (모든 계산이 끝난 뒤에는 바뀌지 않으므로 사본끼리 나눠 가진다)
+    struct Build {
+        Build(const Graph& graph, int exitId, int k, const NodeBitset& blocked)
+            : graph(&graph), exitId(exitId), k(k), blocked(blocked), states(graph.size()) {}
+
+        const Graph* graph;
+        int exitId;
+        int k;
+        NodeBitset blocked;
+        std::vector<std::atomic<int>> states;
+    };
+
+    // 아직 아무도 시작하지 않은 노드 u의 계산을 맡아 slot에 채우는 함수 (작업 스레드와 awaitNode 중 먼저 맡은 쪽이 계산한다)
+    static void computeQueued(Build& job, int u, std::vector<RoutePath>& slot) {
+        int expected = Queued;
+        if (!job.states[u].compare_exchange_strong(expected, Running)) return;
+        slot = yenKShortestPaths(*job.graph, u, job.exitId, job.k, job.blocked);
+        job.states[u].store(Done);
+    }
+
+    std::vector<std::vector<RoutePath>> routes;  // 노드 ID별 대체 경로 (갈림길이 아니거나 경로가 없으면 비어 있음)
+    std::shared_ptr<Build> build;  // precompute로 넣은 계산 (미리 계산하지 않았으면 nullptr)
+};
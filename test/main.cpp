@@ -8,25 +8,45 @@
 #include <cmath>
 #include <queue>
 #include <unordered_map>
-#include <unordered_set>
 #include <algorithm>
 #include <ctime>
+#include <cstdint>
 #include <chrono>
-
-// Node Ŭ 
+#include <memory>
+
+#include "graph.h"
+#include "node_bitset.h"
+#include "monte_carlo.h"
+#include "event_simulation.h"
+#include "fire_animation.h"
+#include "hazard.h"
+#include "crowd.h"
+#include "flow.h"
+#include "evacuation_plan.h"
+#include "exit_assignment.h"
+#include "thread_pool.h"
+#include "simulation.h"
+#include "random.h"
+#include "batch.h"
+#include "replay.h"
+#include "branching.h"
+#include "planner.h"
+
+// Node 클래스 정의
 class Node {
 public:
-    std::string code;  //  ڵ
-    std::string centralNode;  // ߾   (߾   "O")
-    double latitude;  // 
-    double longitude;  // 浵
-    std::vector<std::pair<std::string, double>> nearNodes;  //     ġ
+    std::string code;  // 노드 코드
+    std::string centralNode;  // 중앙 노드 여부 (중앙 노드일 경우 "O")
+    double latitude;  // 위도
+    double longitude;  // 경도
+    std::vector<std::pair<std::string, double>> nearNodes;  // 인접 노드 목록 및 가중치
+    std::vector<double> capacities;  // 인접 간선별 용량 (CSV에 용량 열이 없거나 비어 있으면 0)
 
     Node(std::string c, std::string cn, double lat, double lon,
         std::vector<std::pair<std::string, double>> nn)
         : code(c), centralNode(cn), latitude(lat), longitude(lon), nearNodes(nn) {}
 
-    //csv   д ׽Ʈ
+    //csv 파일을 제대로 읽는지 테스트
     void display() const {
         std::cout << "Code: " << code << "\n";
         std::cout << "Central Node: " << centralNode << "\n";
@@ -40,7 +60,7 @@ public:
     }
 };
 
-// ڿ (delimiter) ϴ Լ
+// 문자열을 구분자(delimiter)로 분할하는 함수
 std::vector<std::string> split(const std::string& s, char delimiter) {
     std::vector<std::string> tokens;
     std::string token;
@@ -51,17 +71,18 @@ std::vector<std::string> split(const std::string& s, char delimiter) {
     return tokens;
 }
 
-// CSV  о Node ü ͸ ȯϴ Լ
+// CSV 파일을 읽어 Node 객체들의 벡터를 반환하는 함수
 std::vector<Node> readCSV(const std::string& filename) {
     std::ifstream file(filename);
     std::string line;
 
     std::vector<Node> nodes;
 
-    //  ŵ
+    // 헤더에 capacity0 열이 있으면 인접 노드마다 (노드, 가중치, 용량) 세 열을 읽는다
     std::getline(file, line);
+    size_t stride = line.find("capacity0") != std::string::npos ? 3 : 2;
 
-    //  б
+    // 데이터 읽기
     while (std::getline(file, line)) {
         auto tokens = split(line, ',');
 
@@ -71,20 +92,25 @@ std::vector<Node> readCSV(const std::string& filename) {
         double longitude = std::stod(tokens[3]);
 
         std::vector<std::pair<std::string, double>> nearNodes;
-        for (size_t i = 4; i < tokens.size(); i += 2) {
+        std::vector<double> capacities;
+        for (size_t i = 4; i < tokens.size(); i += stride) {
             if (tokens[i].empty()) break;
             std::string nearNode = tokens[i];
             double weight = std::stod(tokens[i + 1]);
             nearNodes.push_back({ nearNode, weight });
+            if (stride == 3) {
+                capacities.push_back(i + 2 < tokens.size() && !tokens[i + 2].empty() ? std::stod(tokens[i + 2]) : 0.0);
+            }
         }
 
         nodes.emplace_back(code, centralNode, latitude, longitude, nearNodes);
+        nodes.back().capacities = capacities;
     }
 
     return nodes;
 }
 
-//  ǥ ȭϴ Լ
+// 노드의 좌표를 정규화하는 함수
 void normalizeNodes(std::vector<Node>& nodes) {
     double minLat = std::numeric_limits<double>::max();
     double maxLat = std::numeric_limits<double>::lowest();
@@ -104,358 +130,556 @@ void normalizeNodes(std::vector<Node>& nodes) {
     }
 }
 
-// ͽƮ ˰ Ͽ ִ θ ã Լ
-std::vector<std::string> dijkstra(const std::vector<Node>& nodes, const std::string& startCode, const std::string& exitCode, const std::unordered_set<std::string>& fireNodes) {
-    std::unordered_map<std::string, double> distances;
-    std::unordered_map<std::string, std::string> previous;
-    auto cmp = [&distances](const std::string& left, const std::string& right) { return distances[left] > distances[right]; };
-    //켱 ť 
-    std::priority_queue<std::string, std::vector<std::string>, decltype(cmp)> queue(cmp);
-
-    //  Ÿ  ʱȭ
-    for (const auto& node : nodes) {
-        distances[node.code] = std::numeric_limits<double>::infinity();
-        previous[node.code] = "";
-    }
-    //۳ Ÿ 0   켱 ť 
-    distances[startCode] = 0;
-    queue.push(startCode);
-
-    while (!queue.empty()) {
-        std::string current = queue.top();
-        queue.pop();
+// 가중치를 정규화하는 함수(최소 minTravelTime, 최대 maxTravelTime)
+double normalizeWeight(double weight, double minWeight, double maxWeight, const double minTravelTime, const double maxTravelTime) {
+    return minTravelTime + (maxTravelTime - minTravelTime) * (weight - minWeight) / (maxWeight - minWeight);
+}
 
-        if (current == exitCode) break;
+// 스레드 풀 지표 출력
+void printPoolStats(const ThreadPoolStats& stats) {
+    std::cout << "Thread pool: " << stats.workers << " workers, " << stats.executed << " tasks, " << stats.steals << " steals, peak queue depth "
+        << stats.peakQueued << " (now " << stats.queued[0] << " normal / " << stats.queued[1] << " background)" << std::endl;
+}
 
-        const Node* currentNode = nullptr;
-        for (const auto& node : nodes) {
-            if (node.code == current) {
-                currentNode = &node;
-                break;
-            }
+int main(int argc, char* argv[]) {
+    // 명령행 옵션 처리
+    // --monte-carlo <횟수> : 화면 없이 임의 시나리오를 병렬로 실행하고 결과를 CSV로 저장
+    // --threads <개수>, --output <파일> : 몬테카를로 실행 스레드 수와 결과 파일
+    // --headless : 창을 띄우지 않고 게임과 같은 시뮬레이션을 다음 사건 시각으로 건너뛰며 끝까지 실행하고 결과를 CSV 한 행으로 출력
+    // --batch <파일> : 시나리오 목록(start,exits,ignitions,planner,seed)을 병렬로 실행하고 시나리오마다 결과 행을 CSV로 저장
+    // --sweep : 모든 (시작 노드, 발화 노드) 쌍을 시나리오로 만들어 --batch와 같이 실행
+    // --planner <이름[,이름...]> : 처음 경로와 다시 찾는 경로를 모두 맡는 경로 탐색기 (기본값 time-aware, --sweep은 탐색기마다 모든 쌍을 실행)
+    // --max-flow : 중앙 노드(건물)들에서 탈출구로의 최대 대피 유량과 병목 통로(최소 컷)를 출력
+    // --evacuation-plan <인원> : 건물(중앙 노드)마다 인원을 고르게 나누어 두고, 모든 인원의 경로와 출발 시각을 정하는 대피 계획을 CSV로 저장
+    // --exit-assignment <인원> : 건물마다 인원을 고르게 나누어 두고, 걷는 시간과 탈출구 대기 시간의 합이 최소가 되도록 탈출구를 배정 (최소 비용 유량)
+    // --exits <개수> : 대피 용량 분석/대피 계획/탈출구 배정에 쓸 탈출구 수 (기본 출구에서 가장 먼 노드를 차례로 추가)
+    // --agents <인원> : 플레이어와 함께 임의의 노드에서 대피하는 군중 에이전트 수 (--threads로 갱신 스레드 수 지정)
+    // --seed <정수> : 발화 지점, 군중 출발 위치, 몬테카를로 시나리오를 정하는 난수 시드 (기본값은 현재 시각, 실행할 때 출력)
+    // --record <파일> : 게임 한 판(또는 --headless 실행)의 화재, 경로 변경, 플레이어/군중 이동을 리플레이 파일로 기록
+    // --replay <파일> [--at <초>] : 리플레이 파일에서 지정한 시각(기본값은 끝)의 상태를 출력
+    // --branch <개수> [--split <초>] : 게임 시나리오를 지정한 시각(기본값 15초)까지 한 번 진행한 뒤, 그 스냅샷에서 화재가 다르게 번지는 미래들을 병렬로 실행하고 결과를 CSV로 저장
+    int monteCarloRuns = 0;
+    bool headless = false;
+    std::string batchPath;
+    bool sweep = false;
+    int agentCount = 0;
+    bool maxFlow = false;
+    int planOccupants = 0;
+    int assignOccupants = 0;
+    int exitCount = 1;
+    int threadCount = 0;
+    std::uint64_t seed = static_cast<std::uint64_t>(std::time(nullptr));
+    std::string recordPath;
+    std::string replayPath;
+    double replayTime = -1.0; // 음수이면 리플레이의 끝
+    BranchConfig branchConfig;
+    branchConfig.branches = 0;
+    std::vector<std::string> planners = { "time-aware" };
+    std::string outputPath; // 비어 있으면 모드별 기본 파일
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        if (arg == "--monte-carlo" && i + 1 < argc) {
+            monteCarloRuns = std::stoi(argv[++i]);
         }
-        if (!currentNode) continue;
-
-        for (const auto& neighbor : currentNode->nearNodes) {
-            if (fireNodes.find(neighbor.first) != fireNodes.end()) {
-                continue; // ȭ簡 ߻  ̵ 
-            }
-            double alt = distances[current] + neighbor.second;
-            if (alt < distances[neighbor.first]) {
-                distances[neighbor.first] = alt;
-                previous[neighbor.first] = current;
-                queue.push(neighbor.first);
-            }
+        else if (arg == "--threads" && i + 1 < argc) {
+            threadCount = std::stoi(argv[++i]);
         }
-    }
-
-    //ǥ    previous  Ͽ θ Ѵ. ,  θ  ִ η ȯѴ.
-    std::vector<std::string> path;
-    if (distances[exitCode] == std::numeric_limits<double>::infinity()) {
-        return {}; // ΰ     ȯ
-    }
-    for (std::string at = exitCode; !at.empty(); at = previous[at]) {
-        path.push_back(at);
-    }
-    std::reverse(path.begin(), path.end());
-    return path;
-}
-
-
-// bellman-ford ˰ Ͽ ִ θ ã Լ
-std::vector<std::string> bellmanFord(const std::vector<Node>& nodes, const std::string& startCode, const std::string& exitCode, const std::unordered_set<std::string>& fireNodes) {
-    std::unordered_map<std::string, double> distances;
-    std::unordered_map<std::string, std::string> previous;
-
-    for (const auto& node : nodes) {
-        distances[node.code] = std::numeric_limits<double>::infinity();
-        previous[node.code] = "";
-    }
-    distances[startCode] = 0.0;
-
-    for (size_t i = 0; i < nodes.size() - 1; ++i) {     // (  - 1) ݺ  
-        for (const auto& node : nodes) {
-            if (distances[node.code] == std::numeric_limits<double>::infinity()) continue;
-            for (const auto& neighbor : node.nearNodes) {
-                if (fireNodes.find(neighbor.first) != fireNodes.end()) continue; // ȭ簡 ߻ δ ̵ 
-                // ݱ neighbor Ÿ  node ģ neighbor Ÿ    Ʈ 
-                if (distances[neighbor.first] > distances[node.code] + neighbor.second) {
-                    distances[neighbor.first] = distances[node.code] + neighbor.second;
-                    previous[neighbor.first] = node.code;
+        else if (arg == "--output" && i + 1 < argc) {
+            outputPath = argv[++i];
+        }
+        else if (arg == "--headless") {
+            headless = true;
+        }
+        else if (arg == "--batch" && i + 1 < argc) {
+            batchPath = argv[++i];
+        }
+        else if (arg == "--sweep") {
+            sweep = true;
+        }
+        else if (arg == "--evacuation-plan" && i + 1 < argc) {
+            planOccupants = std::stoi(argv[++i]);
+        }
+        else if (arg == "--exit-assignment" && i + 1 < argc) {
+            assignOccupants = std::stoi(argv[++i]);
+        }
+        else if (arg == "--exits" && i + 1 < argc) {
+            exitCount = std::max(1, std::stoi(argv[++i]));
+        }
+        else if (arg == "--max-flow") {
+            maxFlow = true;
+        }
+        else if (arg == "--agents" && i + 1 < argc) {
+            agentCount = std::stoi(argv[++i]);
+        }
+        else if (arg == "--seed" && i + 1 < argc) {
+            seed = std::stoull(argv[++i]);
+        }
+        else if (arg == "--record" && i + 1 < argc) {
+            recordPath = argv[++i];
+        }
+        else if (arg == "--replay" && i + 1 < argc) {
+            replayPath = argv[++i];
+        }
+        else if (arg == "--at" && i + 1 < argc) {
+            replayTime = std::stod(argv[++i]);
+        }
+        else if (arg == "--branch" && i + 1 < argc) {
+            branchConfig.branches = std::stoi(argv[++i]);
+        }
+        else if (arg == "--split" && i + 1 < argc) {
+            branchConfig.splitTime = std::stod(argv[++i]);
+        }
+        else if (arg == "--planner" && i + 1 < argc) {
+            planners.clear();
+            std::istringstream names(argv[++i]);
+            for (std::string name; std::getline(names, name, ',');) {
+                if (!hasPlanner(name)) {
+                    std::cerr << "Unknown planner: " << name << " (available: " << plannerNames() << ")" << std::endl;
+                    return 1;
                 }
+                planners.push_back(name);
             }
+            if (planners.empty()) {
+                std::cerr << "Missing planner name (available: " << plannerNames() << ")" << std::endl;
+                return 1;
+            }
+        }
+        else {
+            std::cerr << "Unknown option: " << arg << std::endl;
+            return 1;
         }
     }
 
-    std::vector<std::string> path;
-    for (std::string at = exitCode; !at.empty(); at = previous[at]) {
-        path.push_back(at);
-    }
-    std::reverse(path.begin(), path.end());
+    // CSV 파일 경로 설정
+    std::string csvFilePath = "nodes.csv";
 
-    // ⱸ  ΰ  
-    if (path.size() == 1 && path[0] == startCode) {
-        path.clear();
+    // CSV 파일 읽기 및 정규화
+    std::vector<Node> nodes = readCSV(csvFilePath);
+    if (nodes.empty()) {
+        std::cerr << "Error: No nodes were loaded from the CSV file." << std::endl;
+        return 1; // 오류 코드 반환
     }
 
-    return path;
-}
+    normalizeNodes(nodes);
 
-// ÷̵ ˰ Ͽ ִ θ ã Լ
-std::vector<std::string> floydWarshall(const std::vector<Node>& nodes, const std::string& startCode, const std::string& exitCode, const std::unordered_set<std::string>& fireNodes) {
-    //  ڵ ε ϴ  
-    std::unordered_map<std::string, int> nodeIndex;
-    int n = nodes.size();
-    for (int i = 0; i < n; ++i) {
-        nodeIndex[nodes[i].code] = i;
-    }
+    // 노드 코드를 정수 ID로 바꾼 CSR 그래프 생성
+    Graph graph = buildGraph(nodes);
 
-    // Ÿ  ʱȭ
-    std::vector<std::vector<double>> dist(n, std::vector<double>(n, std::numeric_limits<double>::infinity()));
-    std::vector<std::vector<int>> next(n, std::vector<int>(n, -1));
+    // 플레이어와 출구의 임의 위치 설정
+    /*std::string playerNodeCode = nodes[std::rand() % nodes.size()].code;
+    std::string exitNodeCode = nodes[std::rand() % nodes.size()].code;*/
 
-    for (int i = 0; i < n; ++i) {
-        dist[i][i] = 0;
-        next[i][i] = i;
-    }
+    // 플레이어와 출구의 위치를 고정
+    auto playerNodeIt = std::min_element(nodes.begin(), nodes.end(), [](const Node& a, const Node& b) {
+        return a.longitude < b.longitude;
+    });
+    auto exitNodeIt = std::max_element(nodes.begin(), nodes.end(), [](const Node& a, const Node& b) {
+        return a.longitude < b.longitude;
+    });
+    std::string playerNodeCode = playerNodeIt->code;
+    std::string exitNodeCode = exitNodeIt->code;
+    int playerId = graph.id(playerNodeCode);
+    int exitId = graph.id(exitNodeCode);
 
+    // 최소 및 최대 가중치 찾기
+    double minWeight = std::numeric_limits<double>::max();
+    double maxWeight = std::numeric_limits<double>::lowest();
     for (const auto& node : nodes) {
-        int u = nodeIndex[node.code];
         for (const auto& neighbor : node.nearNodes) {
-            if (fireNodes.find(neighbor.first) == fireNodes.end()) { // ȭ簡 ߻   
-                int v = nodeIndex[neighbor.first];
-                dist[u][v] = neighbor.second;
-                next[u][v] = v;
-            }
+            if (neighbor.second < minWeight) minWeight = neighbor.second;
+            if (neighbor.second > maxWeight) maxWeight = neighbor.second;
         }
     }
 
-    // ÷̵- ˰ 
-    for (int k = 0; k < n; ++k) {
-        for (int i = 0; i < n; ++i) {
-            for (int j = 0; j < n; ++j) {
-                if (dist[i][k] + dist[k][j] < dist[i][j]) {
-                    dist[i][j] = dist[i][k] + dist[k][j];
-                    next[i][j] = next[i][k];
-                }
-            }
-        }
-    }
+    const double minTravelTime = 0.3; // 간선 이동의 최소 시간
+    const double maxTravelTime = 3.0; // 간선 이동의 최대 시간
 
-    //  籸
-    std::vector<std::string> path;
-    int u = nodeIndex[startCode];
-    int v = nodeIndex[exitCode];
+    // 간선 e를 플레이어가 지나는 데 걸리는 시간
+    auto edgeTravelTime = [&](int e) {
+        return normalizeWeight(graph.weights[e], minWeight, maxWeight, minTravelTime, maxTravelTime);
+    };
 
-    if (next[u][v] == -1) {
-        // ΰ  
-        return path;
+    std::vector<double> travelTimes(graph.targets.size());
+    for (size_t e = 0; e < travelTimes.size(); ++e) {
+        travelTimes[e] = edgeTravelTime(static_cast<int>(e));
     }
 
-    while (u != v) {
-        path.push_back(nodes[u].code);
-        u = next[u][v];
+    // 분석 모드의 탈출구: 기본 출구에서 시작해, 지금까지 고른 탈출구들에서 가장 멀리 떨어진 건물 밖 노드를 하나씩 추가
+    std::vector<int> exits = { exitId };
+    while (static_cast<int>(exits.size()) < exitCount) {
+        std::vector<double> dist = nearestExits(graph, travelTimes, exits).first;
+        int farthest = -1;
+        for (int id = 0; id < graph.size(); ++id) {
+            if (nodes[id].centralNode == "O" || dist[id] == std::numeric_limits<double>::infinity()) continue;
+            if (farthest < 0 || dist[id] > dist[farthest]) farthest = id;
+        }
+        if (farthest < 0 || dist[farthest] == 0.0) break;
+        exits.push_back(farthest);
     }
-    path.push_back(nodes[v].code);
-
-    return path;
-}
-
-// A* ˰  ޸ƽ 
-//    Ŭ Ÿ Ͽ ȯ
-double heuristic(const Node& a, const Node& b) {
-    return std::sqrt((a.latitude - b.latitude) * (a.latitude - b.latitude) +
-        (a.longitude - b.longitude) * (a.longitude - b.longitude));
-}
 
-//A* ˰ ̿Ͽ ִ θ ã Լ
-std::vector<std::string> astar(const std::vector<Node>& nodes, const std::string& startCode, const std::string& exitCode, const std::unordered_set<std::string>& fireNodes) {
-    std::unordered_map<std::string, double> gScore, /* 忡 Ư   */ fScore; //  忡 ǥ    (gScore + ޸ƽ)
-    std::unordered_map<std::string, std::string> cameFrom; //    带 Ͽ θ 籸
-    // 켱 ť Ͽ fScore  带 켱 Ž
-    auto cmp = [&fScore](const std::string& left, const std::string& right) { return fScore[left] > fScore[right]; };
-    std::priority_queue<std::string, std::vector<std::string>, decltype(cmp)> openSet(cmp);
-
-    //ʱȭ:   gScore fScore Ѵ 
-    for (const auto& node : nodes) {
-        gScore[node.code] = std::numeric_limits<double>::infinity();
-        fScore[node.code] = std::numeric_limits<double>::infinity();
+    // 건물(중앙 노드)들과, 인원을 건물마다 고르게 나누어 둔 노드별 인원
+    std::vector<int> buildings;
+    for (int id = 0; id < graph.size(); ++id) {
+        if (nodes[id].centralNode == "O") buildings.push_back(id);
+    }
+    auto spreadOccupants = [&](int count) {
+        std::vector<int> occupants(graph.size(), 0);
+        for (int i = 0; i < count; ++i) {
+            occupants[buildings[i % buildings.size()]]++;
+        }
+        return occupants;
+    };
+
+    // 대피 용량 분석 모드: 두 최대 유량 알고리즘의 결과와 시간을 비교하고, 병목 통로를 용량이 작은 순으로 출력
+    if (maxFlow) {
+        std::vector<double> capacities = edgeCapacities(graph, nodes, CapacityConfig());
+        const std::vector<int>& occupied = buildings;
+
+        EvacuationCapacity result;
+        const FlowEngine engines[] = { FlowEngine::EdmondsKarp, FlowEngine::Dinic };
+        const char* engineNames[] = { "Edmonds-Karp", "Dinic" };
+        for (int i = 0; i < 2; ++i) {
+            auto flowStartTime = std::chrono::high_resolution_clock::now();
+            result = analyzeEvacuation(graph, capacities, occupied, exits, engines[i]);
+            std::chrono::duration<double> flowDuration = std::chrono::high_resolution_clock::now() - flowStartTime;
+            std::cout << engineNames[i] << ": max evacuation flow " << result.throughput << " persons/s from "
+                << occupied.size() << " buildings, wall time: " << flowDuration.count() << " seconds" << std::endl;
+        }
+        std::cout << "Bottleneck corridors (min cut):" << std::endl;
+        for (const auto& corridor : result.bottlenecks) {
+            std::cout << "  " << graph.codes[corridor.first] << " -> " << graph.codes[graph.targets[corridor.second]]
+                << " capacity " << capacities[corridor.second] << std::endl;
+        }
+        return 0;
     }
-    gScore[startCode] = 0.0; //   gScore 0
-    fScore[startCode] = heuristic(nodes[0], nodes[0]); // ʱ ޸ƽ   (ڱ ڽŰ Ÿ̹Ƿ 0)
-
-    openSet.push(startCode); //  带 켱 ť ߰
 
-    while (!openSet.empty()) {
-        std::string current = openSet.top(); // fScore   带 
-        openSet.pop();
+    // 대피 계획 모드: 1초 단위 시간 확장 네트워크에서 모든 인원의 경로와 출발 시각을 정한다
+    if (planOccupants > 0) {
+        const double stepSeconds = 1.0;
+        std::vector<double> capacities = edgeCapacities(graph, nodes, CapacityConfig());
+        std::vector<int> transitSteps(graph.targets.size());
+        std::vector<double> capacityPerStep(graph.targets.size());
+        for (size_t e = 0; e < graph.targets.size(); ++e) {
+            transitSteps[e] = std::max(1, static_cast<int>(std::lround(travelTimes[e] / stepSeconds)));
+            capacityPerStep[e] = capacities[e] * stepSeconds; // 단계마다 나눠 받으므로 소수 부분을 버리지 않는다
+        }
 
-        if (current == exitCode) { // ǥ 忡   θ 籸Ͽ ȯ
-            std::vector<std::string> path;
-            for (std::string at = exitCode; !at.empty(); at = cameFrom[at]) {
-                path.push_back(at);
+        std::vector<int> occupants = spreadOccupants(planOccupants);
+
+        auto planStartTime = std::chrono::high_resolution_clock::now();
+        EvacuationPlanner planner(graph, transitSteps, capacityPerStep);
+        EvacuationPlan plan = planner.plan(occupants, exits);
+        std::chrono::duration<double> planDuration = std::chrono::high_resolution_clock::now() - planStartTime;
+        std::cout << "Occupants: " << planOccupants << ", groups: " << plan.groups.size() << ", unrouted: " << plan.unrouted
+            << ", evacuation time: " << plan.makespan * stepSeconds << " seconds, searches: " << plan.searches
+            << ", wall time: " << planDuration.count() << " seconds" << std::endl;
+
+        if (outputPath.empty()) outputPath = "evacuation_plan.csv";
+        std::ofstream file(outputPath);
+        if (!file) {
+            std::cerr << "Error: Could not write " << outputPath << std::endl;
+            return 1;
+        }
+        file << "source,exit,count,departure,arrival,route\n";
+        for (const auto& group : plan.groups) {
+            file << graph.codes[group.source] << ',' << graph.codes[group.exit] << ',' << group.count << ','
+                << (group.departures.empty() ? 0 : group.departures[0]) * stepSeconds << ',' << group.arrival * stepSeconds << ',';
+            for (size_t i = 0; i < group.nodes.size(); ++i) {
+                file << (i > 0 ? " " : "") << graph.codes[group.nodes[i]];
             }
-            std::reverse(path.begin(), path.end()); // θ  Ƿ  ݴ 
-            return path;
+            file << '\n';
         }
+        return 0;
+    }
 
-        const Node* currentNode = nullptr; //  带 ã
-        for (const auto& node : nodes) {
-            if (node.code == current) {
-                currentNode = &node;
-                break;
+    // 탈출구 배정 모드: 가장 가까운 탈출구로 모두 보내는 배정과 최소 비용 유량 배정을 비교하고, 최소 비용 배정을 CSV로 저장
+    if (assignOccupants > 0) {
+        std::vector<double> capacities = edgeCapacities(graph, nodes, CapacityConfig());
+        std::vector<double> exitRates;
+        for (int id : exits) {
+            exitRates.push_back(exitThroughput(graph, capacities, id));
+        }
+        std::vector<int> occupants = spreadOccupants(assignOccupants);
+
+        auto printAssignment = [&](const char* name, const ExitAssignment& assignment, double seconds) {
+            std::cout << name << ": walk " << assignment.walkCost << " s, queue " << assignment.queueCost
+                << " s, last exit clears at " << assignment.clearTime << " s, unassigned " << assignment.unassigned
+                << ", wall time: " << seconds << " seconds" << std::endl;
+            for (size_t i = 0; i < exits.size(); ++i) {
+                std::cout << "  " << graph.codes[exits[i]] << " (" << exitRates[i] << " persons/s): "
+                    << assignment.exitLoads[i] << " persons" << std::endl;
             }
+        };
+
+        auto assignStartTime = std::chrono::high_resolution_clock::now();
+        ExitAssignment nearest = assignNearestExits(graph, travelTimes, occupants, exits, exitRates);
+        std::chrono::duration<double> nearestDuration = std::chrono::high_resolution_clock::now() - assignStartTime;
+        printAssignment("Nearest exit", nearest, nearestDuration.count());
+
+        assignStartTime = std::chrono::high_resolution_clock::now();
+        ExitAssignment balanced = assignExitsMinCost(graph, travelTimes, occupants, exits, exitRates);
+        std::chrono::duration<double> balancedDuration = std::chrono::high_resolution_clock::now() - assignStartTime;
+        printAssignment("Min-cost flow", balanced, balancedDuration.count());
+        std::cout << "Augmenting paths: " << balanced.augmentations << std::endl;
+
+        if (outputPath.empty()) outputPath = "exit_assignment.csv";
+        std::ofstream file(outputPath);
+        if (!file) {
+            std::cerr << "Error: Could not write " << outputPath << std::endl;
+            return 1;
+        }
+        file << "source,exit,count\n";
+        for (const auto& flow : balanced.flows) {
+            file << graph.codes[flow.source] << ',' << graph.codes[exits[flow.exit]] << ',' << flow.count << '\n';
         }
-        if (!currentNode) continue;
+        return 0;
+    }
 
-        //    带 Ž
-        for (const auto& neighbor : currentNode->nearNodes) {
-            if (fireNodes.find(neighbor.first) != fireNodes.end()) {
-                continue; //ȭ簡 ߻  Ž 
-            }
-            double tentative_gScore = gScore[current] + neighbor.second; // ο gScore 
-            if (tentative_gScore < gScore[neighbor.first]) { //   gScore ߰  
-                cameFrom[neighbor.first] = current; // θ 籸ϱ    
-                gScore[neighbor.first] = tentative_gScore;
-
-                const Node* neighborNode = nullptr;
-                // 带 ã
-                for (const auto& node : nodes) {
-                    if (node.code == neighbor.first) {
-                        neighborNode = &node;
-                        break;
-                    }
-                }
-                if (neighborNode) { // fScore : gScore + ޸ƽ
-                    fScore[neighbor.first] = gScore[neighbor.first] + heuristic(*neighborNode, *currentNode);
-                    openSet.push(neighbor.first); //  带 켱 ť ߰
-                }
+    // 리플레이 모드: 기록한 파일에서 지정한 시각의 상태를 키프레임부터 복원해 출력
+    if (!replayPath.empty()) {
+        ReplayReader reader(graph, travelTimes);
+        std::string error;
+        if (!reader.open(replayPath, error)) {
+            std::cerr << "Error: " << error << std::endl;
+            return 1;
+        }
+        ReplayState state;
+        auto seekStartTime = std::chrono::high_resolution_clock::now();
+        reader.seek(replayTime < 0.0 ? reader.duration() : replayTime, state);
+        std::chrono::duration<double> seekDuration = std::chrono::high_resolution_clock::now() - seekStartTime;
+
+        const char* statusNames[] = { "moving", "escaped", "no initial path", "trapped" };
+        std::cout << "Replay: " << reader.duration() << " seconds, " << reader.frames() << " frames, "
+            << reader.keyframeCount() << " keyframes" << std::endl;
+        std::cout << "Time: " << state.time << " seconds (seek took " << seekDuration.count() << " seconds)" << std::endl;
+        int burningCount = 0;
+        state.fireNodes.forEach([&](int) { burningCount++; });
+        std::cout << "Burning nodes: " << burningCount << std::endl;
+        std::cout << "Player: " << statusNames[static_cast<int>(state.playerStatus)];
+        if (!state.playerPath.empty()) {
+            std::cout << " at " << graph.codes[state.playerPath[state.pathPosition]];
+            if (state.playerStatus == AgentStatus::Moving) {
+                std::cout << " -> " << graph.codes[state.playerPath[state.pathPosition + 1]] << " (" << state.playerProgress << ")";
             }
         }
+        std::cout << std::endl;
+        if (!state.agentStatuses.empty()) {
+            int counts[3] = { 0, 0, 0 };
+            for (CrowdStatus status : state.agentStatuses) counts[static_cast<int>(status)]++;
+            std::cout << "Agents: " << state.agentStatuses.size() << ", moving: " << counts[0] << ", escaped: " << counts[1]
+                << ", trapped: " << counts[2] << std::endl;
+        }
+        return 0;
     }
 
-    return {}; //ǥ 忡       ȯ
-}
+    // 여기부터의 모드는 난수를 쓰므로, 같은 결과를 다시 얻을 수 있도록 시드를 출력한다
+    std::cout << "Seed: " << seed << std::endl;
 
-// ġ ȭϴ Լ(ּ minTravelTime, ִ maxTravelTime)
-double normalizeWeight(double weight, double minWeight, double maxWeight, const double minTravelTime, const double maxTravelTime) {
-    return minTravelTime + (maxTravelTime - minTravelTime) * (weight - minWeight) / (maxWeight - minWeight);
-}
+    // 몬테카를로 모드: 창을 띄우지 않고 시나리오를 일괄 실행한 뒤 종료
+    if (monteCarloRuns > 0) {
 
-// ȭ ִϸ̼  ü
-struct Fire {
-    sf::CircleShape shape;
-    std::string startNode;
-    std::string endNode;
-    double interpolation;
-    Fire(const sf::CircleShape& shape, const std::string& startNode, const std::string& endNode)
-        : shape(shape), startNode(startNode), endNode(endNode), interpolation(0.0) {}
-};
+        MonteCarloConfig config;
+        config.runs = monteCarloRuns;
+        config.threads = threadCount;
+        config.seed = seed;
+        config.fireTick = maxTravelTime;
 
-//    ϴ Լ
-void resetPathEdgesColors(const std::vector<std::string>& path, std::unordered_map<std::string, sf::CircleShape>& nodeMap, std::vector<sf::VertexArray>& pathEdgesShapes, const sf::Color& color) {
-    for (size_t i = 1; i < path.size(); ++i) {
-        const auto& startNode = nodeMap[path[i - 1]];
-        const auto& endNode = nodeMap[path[i]];
-        for (auto& edge : pathEdgesShapes) {
-            if ((edge[0].position == startNode.getPosition() && edge[1].position == endNode.getPosition()) ||
-                (edge[1].position == startNode.getPosition() && edge[0].position == endNode.getPosition())) {
-                edge[0].color = color;
-                edge[1].color = color;
-            }
+        auto batchStartTime = std::chrono::high_resolution_clock::now();
+        std::vector<ScenarioResult> results = runMonteCarlo(graph, travelTimes, exitId, config);
+        std::chrono::duration<double> batchDuration = std::chrono::high_resolution_clock::now() - batchStartTime;
+
+        int escapedCount = 0;
+        for (const auto& result : results) {
+            if (result.result == EscapeResult::Escaped) escapedCount++;
+        }
+        std::cout << "Scenarios: " << results.size() << ", escaped: " << escapedCount
+            << " (" << 100.0 * escapedCount / results.size() << "%), wall time: " << batchDuration.count() << " seconds" << std::endl;
+        printPoolStats(sharedPool().stats());
+
+        if (outputPath.empty()) outputPath = "monte_carlo.csv";
+        if (!writeMonteCarloCSV(outputPath, graph, results)) {
+            std::cerr << "Error: Could not write " << outputPath << std::endl;
+            return 1;
         }
+        return 0;
     }
-}
 
-//    ġ  Լ
-double getWeight(const std::string& from, const std::string& to, const std::vector<Node>& nodes) {
-    for (const auto& node : nodes) {
-        if (node.code == from) {
-            for (const auto& neighbor : node.nearNodes) {
-                if (neighbor.first == to) {
-                    return neighbor.second;
+    // 일괄 실행 모드: 시나리오마다 헤드리스 시뮬레이션을 병렬로 실행하고, 끝나는 대로 입력 순서에 맞춰 결과 행을 내보낸다
+    if (!batchPath.empty() || sweep) {
+        std::vector<BatchScenario> scenarios;
+        if (sweep) {
+            // 탐색기마다 모든 (시작 노드, 발화 노드) 쌍, 시드는 쌍 번호의 스트림에서 뽑으므로 탐색기끼리 같은 시나리오를 비교한다
+            for (const std::string& planner : planners) {
+                std::uint64_t pair = 0;
+                for (int start = 0; start < graph.size(); ++start) {
+                    for (int ignition = 0; ignition < graph.size(); ++ignition) {
+                        BatchScenario scenario;
+                        scenario.startId = start;
+                        scenario.exits = exits;
+                        scenario.ignitions = { ignition };
+                        scenario.planner = planner;
+                        scenario.seed = Random(seed, pair++).next();
+                        scenarios.push_back(scenario);
+                    }
                 }
             }
         }
-    }
-    return 1.0; // ⺻ ġ
-}
-
-int main() {
-    sf::RenderWindow window(sf::VideoMode(780, 580), "SFML Nodes Visualization");
-
-    //   ð 
-    auto gameStartTime = std::chrono::high_resolution_clock::now();
+        else {
+            std::string error;
+            if (!readBatchCSV(batchPath, graph, exits, planners.front(), seed, scenarios, error)) {
+                std::cerr << "Error: " << error << std::endl;
+                return 1;
+            }
+        }
 
-    // CSV   
-    std::string csvFilePath = "nodes.csv";
+        BatchConfig config;
+        config.threads = threadCount;
+        config.fireTick = maxTravelTime;
+        config.agents = agentCount;
 
-    // CSV  б  ȭ
-    std::vector<Node> nodes = readCSV(csvFilePath);
-    if (nodes.empty()) {
-        std::cerr << "Error: No nodes were loaded from the CSV file." << std::endl;
-        return 1; //  ڵ ȯ
+        if (outputPath.empty()) outputPath = "batch_results.csv";
+        std::ofstream file(outputPath);
+        if (!file) {
+            std::cerr << "Error: Could not write " << outputPath << std::endl;
+            return 1;
+        }
+        writeBatchHeader(file);
+
+        // 탐색기별 합계 (처음 나온 순서대로)
+        struct PlannerSummary {
+            std::string name;
+            int scenarios = 0;
+            int escaped = 0;
+            int replans = 0;
+            double planSeconds = 0.0;
+            double replanSeconds = 0.0;
+        };
+        std::vector<PlannerSummary> summaries;
+
+        int escapedCount = 0;
+        auto batchStartTime = std::chrono::high_resolution_clock::now();
+        runBatch(graph, travelTimes, edgeCapacities(graph, nodes, CapacityConfig()), scenarios, config, [&](int i, const BatchResult& result) {
+            writeBatchRow(file, graph, i, scenarios[i], result);
+            if (result.status == AgentStatus::Escaped) escapedCount++;
+
+            auto summary = std::find_if(summaries.begin(), summaries.end(), [&](const PlannerSummary& s) { return s.name == scenarios[i].planner; });
+            if (summary == summaries.end()) {
+                summaries.push_back(PlannerSummary());
+                summary = summaries.end() - 1;
+                summary->name = scenarios[i].planner;
+            }
+            summary->scenarios++;
+            if (result.status == AgentStatus::Escaped) summary->escaped++;
+            summary->replans += result.replans;
+            summary->planSeconds += result.planSeconds;
+            summary->replanSeconds += result.replanSeconds;
+        });
+        std::chrono::duration<double> batchDuration = std::chrono::high_resolution_clock::now() - batchStartTime;
+        std::cout << "Scenarios: " << scenarios.size() << ", escaped: " << escapedCount
+            << ", wall time: " << batchDuration.count() << " seconds" << std::endl;
+        for (const auto& summary : summaries) {
+            std::cout << "Planner " << summary.name << ": " << summary.scenarios << " scenarios, escaped: " << summary.escaped
+                << ", plan time: " << summary.planSeconds << " seconds, replans: " << summary.replans
+                << ", replan time: " << summary.replanSeconds << " seconds" << std::endl;
+        }
+        printPoolStats(sharedPool().stats());
+        return 0;
     }
 
-    normalizeNodes(nodes);
-
-    std::srand(static_cast<unsigned int>(std::time(nullptr)));
-
-    // ÷̾ ⱸ  ġ 
-    /*std::string playerNodeCode = nodes[std::rand() % nodes.size()].code;
-    std::string exitNodeCode = nodes[std::rand() % nodes.size()].code;*/
+    // 분기 탐색 모드: 게임 시나리오의 공통 앞부분을 한 번만 진행하고, 스냅샷에서 갈라진 미래마다 다른 노드에 불을 더 붙여 끝까지 실행한다
+    if (branchConfig.branches > 0) {
+        BatchScenario scenario;
+        scenario.startId = playerId;
+        scenario.exits = { exitId };
+        scenario.planner = planners.front();
+        scenario.seed = seed;
+        BatchConfig config;
+        config.threads = threadCount;
+        config.fireTick = maxTravelTime;
+        config.agents = agentCount;
+
+        BranchTiming timing;
+        std::vector<BranchResult> results = exploreBranches(graph, travelTimes, edgeCapacities(graph, nodes, CapacityConfig()),
+            scenario, config, branchConfig, timing);
+
+        if (outputPath.empty()) outputPath = "branches.csv";
+        std::ofstream file(outputPath);
+        if (!file) {
+            std::cerr << "Error: Could not write " << outputPath << std::endl;
+            return 1;
+        }
+        file << "branch,spot_fires,result,escape_time,total_weight,agents_escaped,agents_trapped\n";
+        int escapedCount = 0;
+        for (size_t i = 0; i < results.size(); ++i) {
+            const BranchResult& result = results[i];
+            file << i << ',' << joinNodeCodes(graph, result.spotFires) << ',' << outcomeName(result.status) << ',' << result.escapeTime << ','
+                << result.totalWeight << ',' << result.agentsEscaped << ',' << result.agentsTrapped << '\n';
+            if (result.status == AgentStatus::Escaped) escapedCount++;
+        }
+        std::cout << "Branches: " << results.size() << " from " << branchConfig.splitTime << " seconds, escaped: " << escapedCount << std::endl;
+        std::cout << "Prefix: " << timing.prefixSeconds << " seconds, snapshot: " << timing.snapshotSeconds
+            << " seconds, branches wall time: " << timing.branchSeconds << " seconds" << std::endl;
+        printPoolStats(sharedPool().stats());
+        return 0;
+    }
 
-    // ÷̾ ⱸ ġ 
-    auto playerNodeIt = std::min_element(nodes.begin(), nodes.end(), [](const Node& a, const Node& b) {
-        return a.longitude < b.longitude;
-    });
-    auto exitNodeIt = std::max_element(nodes.begin(), nodes.end(), [](const Node& a, const Node& b) {
-        return a.longitude < b.longitude;
-    });
-    std::string playerNodeCode = playerNodeIt->code;
-    std::string exitNodeCode = exitNodeIt->code;
+    // 헤드리스 모드: 게임과 같은 시나리오 하나를 일괄 실행으로 돌려 결과 행을 콘솔에 출력 (군중은 --threads개 스레드로 갱신)
+    if (headless) {
+        BatchScenario scenario;
+        scenario.startId = playerId;
+        scenario.exits = { exitId };
+        scenario.planner = planners.front();
+        scenario.seed = seed;
+        BatchConfig config;
+        config.fireTick = maxTravelTime;
+        config.agents = agentCount;
+        config.crowdThreads = threadCount;
+
+        BatchResult result = runBatchScenario(graph, travelTimes, edgeCapacities(graph, nodes, CapacityConfig()), scenario, config, recordPath);
+        writeBatchHeader(std::cout);
+        writeBatchRow(std::cout, graph, 0, scenario, result);
+        return result.status == AgentStatus::NoInitialPath ? 1 : 0;
+    }
 
-    // ȭ ߻ ʱȭ
-    std::unordered_set<std::string> fireNodes;
-    fireNodes.insert(nodes[std::rand() % nodes.size()].code);
-
-    std::vector<std::string> path;
-    switch (4) {
-    case 1:
-        // ͽƮ ˰  ã
-        path = dijkstra(nodes, playerNodeCode, exitNodeCode, fireNodes);
-        break;
-    case 2:
-        // bellman-Ford ˰  ã
-        path = bellmanFord(nodes, playerNodeCode, exitNodeCode, fireNodes);
-        break;
-    case 3:
-        // ÷̵  ˰  ã
-        path = floydWarshall(nodes, playerNodeCode, exitNodeCode, fireNodes);
-        break;
-    case 4:
-        // A* ˰  ã
-        path = astar(nodes, playerNodeCode, exitNodeCode, fireNodes);
-        break;
+    // 게임 한 판: 헤드리스 모드와 같은 시뮬레이션을 프레임 간격으로 진행한다
+    // 발화 지점과 군중 출발 위치는 시드의 난수열에서 차례로 뽑는다 (헤드리스 모드와 같은 순서)
+    Random random(seed);
+    SimulationConfig simulationConfig;
+    simulationConfig.playerId = playerId;
+    simulationConfig.exits = { exitId };
+    simulationConfig.ignitions = { random.below(graph.size()) };
+    simulationConfig.planner = planners.front();
+    simulationConfig.fireTick = maxTravelTime; // 현재, 사용자가 최대 가중치 경로를 이동할 때의 시간마다 화재가 확산된다
+    simulationConfig.threads = threadCount;
+    Simulation simulation(graph, travelTimes, edgeCapacities(graph, nodes, CapacityConfig()), simulationConfig);
+
+    // 플레이어와 함께 대피하는 군중 (불타지 않는 임의의 노드에서 출발하여 탈출구 트리를 따라 이동, 붐비는 간선에서는 느려진다)
+    simulation.spawnAgents(agentCount, random);
+    const Crowd& crowd = simulation.crowd();
+
+    // 리플레이 기록 (시뮬레이션보다 나중에 만들어 먼저 소멸하며, 소멸할 때 마지막 상태를 쓰고 파일을 닫는다)
+    std::unique_ptr<ReplayRecorder> recorder;
+    if (!recordPath.empty()) {
+        recorder.reset(new ReplayRecorder(recordPath));
+        if (!recorder->good()) {
+            std::cerr << "Error: Could not write " << recordPath << std::endl;
+            return 1;
+        }
+        recorder->attach(simulation);
     }
 
-    // ΰ   ó
-    if (path.empty()) {
+    // 경로가 없는 경우 처리
+    if (simulation.status() == AgentStatus::NoInitialPath) {
         std::cout << "Initial path is blocked by fire. Exiting game." << std::endl;
         return 1;
     }
 
-    // ּ  ִ ġ ã
-    double minWeight = std::numeric_limits<double>::max();
-    double maxWeight = std::numeric_limits<double>::lowest();
-    for (const auto& node : nodes) {
-        for (const auto& neighbor : node.nearNodes) {
-            if (neighbor.second < minWeight) minWeight = neighbor.second;
-            if (neighbor.second > maxWeight) maxWeight = neighbor.second;
-        }
-    }
+    sf::RenderWindow window(sf::VideoMode(780, 580), "SFML Nodes Visualization");
+
+    // 게임 시작 시간 기록
+    auto gameStartTime = std::chrono::high_resolution_clock::now();
 
-    //   ðȭ غ
+    // 노드와 간선 시각화 준비
     std::vector<sf::CircleShape> nodeShapes;
     std::vector<sf::VertexArray> edgesShapes;
     std::unordered_map<std::string, sf::CircleShape> nodeMap;
@@ -464,20 +688,20 @@ int main() {
     for (const auto& node : nodes) {
         sf::CircleShape shape(5);
         if (node.centralNode == "O") {
-            shape.setFillColor(sf::Color::Green); // centralNode  "O"  ʷϻ 
+            shape.setFillColor(sf::Color::Green); // centralNode 값이 "O"일 때 초록색으로 설정
         }
         else {
-            shape.setFillColor(sf::Color::Yellow); //  ܿ  
+            shape.setFillColor(sf::Color::Yellow); // 그 외에는 노란색으로 설정
         }
-        shape.setPosition(node.longitude * 760 + 10, (1.0 - node.latitude) * 560 + 10); // Y    ߰
+        shape.setPosition(node.longitude * 760 + 10, (1.0 - node.latitude) * 560 + 10); // Y축 반전 및 여백 추가
         if (node.code == playerNodeCode) {
-            shape.setFillColor(sf::Color::Red); // ÷̾ ġ  
+            shape.setFillColor(sf::Color::Red); // 플레이어 위치는 빨간색으로 설정
         }
         if (node.code == exitNodeCode) {
-            shape.setFillColor(sf::Color::Blue); // ⱸ ġ Ķ 
+            shape.setFillColor(sf::Color::Blue); // 출구 위치는 파란색으로 설정
         }
-        if (fireNodes.find(node.code) != fireNodes.end()) {
-            shape.setFillColor(sf::Color::Magenta); // ȭ ߻  ȫ 
+        if (simulation.fireNodes().test(graph.id(node.code))) {
+            shape.setFillColor(sf::Color::Magenta); // 화재 발생 노드는 자홍색으로 설정
         }
         nodeShapes.push_back(shape);
         nodeMap[node.code] = shape;
@@ -503,36 +727,66 @@ int main() {
         }
     }
 
-    //   ðȭ غ
-    for (size_t i = 1; i < path.size(); ++i) {
-        sf::VertexArray line(sf::Lines, 2);
-        const auto& startNode = nodeMap[path[i - 1]];
-        const auto& endNode = nodeMap[path[i]];
+    //최적 경로 간선 시각화 준비 (경로가 바뀔 때마다 다시 만든다)
+    auto buildPathEdges = [&](const std::vector<int>& path) {
+        pathEdgesShapes.clear();
+        for (size_t i = 1; i < path.size(); ++i) {
+            sf::VertexArray line(sf::Lines, 2);
+            const auto& startNode = nodeMap[graph.codes[path[i - 1]]];
+            const auto& endNode = nodeMap[graph.codes[path[i]]];
 
-        line[0].position = startNode.getPosition();
-        line[0].color = sf::Color::Red;
-        line[1].position = endNode.getPosition();
-        line[1].color = sf::Color::Red;
+            line[0].position = startNode.getPosition();
+            line[0].color = sf::Color::Red;
+            line[1].position = endNode.getPosition();
+            line[1].color = sf::Color::Red;
 
-        pathEdgesShapes.push_back(line);
-    }
+            pathEdgesShapes.push_back(line);
+        }
+    };
+    buildPathEdges(simulation.playerPath());
 
-    // θ  ̵ϴ ÷̾ ʱ ġ 
+    // 경로를 따라 이동하는 플레이어의 초기 위치 설정
     sf::CircleShape playerShape(5);
     playerShape.setFillColor(sf::Color::Red);
-    playerShape.setPosition(nodeMap[path[0]].getPosition());
+    playerShape.setPosition(nodeMap[playerNodeCode].getPosition());
 
     sf::Clock clock;
-    sf::Clock fireClock;
-    size_t currentPathIndex = 0;
-    double interpolation = 0.0;
-    const double minTravelTime = 0.3; //  ̵ ּ ð
-    const double maxTravelTime = 3.0; //  ̵ ִ ð
 
-    double totalWeight = 0.0; //  ġ  
+    FireAnimationPool fireAnimations;
+    sf::CircleShape agentShape(2); // 모든 군중 에이전트가 같이 쓰는 도형
+    std::vector<float> nodeX, nodeY, agentX, agentY; // 노드 ID별 화면 좌표와 에이전트별 보간 위치
+    for (const auto& shape : nodeShapes) {
+        nodeX.push_back(shape.getPosition().x);
+        nodeY.push_back(shape.getPosition().y);
+    }
+    agentShape.setFillColor(sf::Color(255, 140, 0));
+    sf::CircleShape fireShape(5); // 모든 화재 애니메이션이 같이 쓰는 도형
+    fireShape.setFillColor(sf::Color::Magenta);
+
+    // 게임 화면은 시뮬레이션의 관찰자: 화재 애니메이션과 경로 표시를 갱신하고, 플레이어가 끝나면 결과를 출력하고 창을 닫는다
+    SimulationObserver screen;
+    screen.onFireSpread = [&](int source, int target, double duration) {
+        fireAnimations.add(source, target, static_cast<float>(duration)); // 화재가 간선을 건너는 시간은 간선 가중치를 정규화한 값
+    };
+    screen.onPathChanged = buildPathEdges; //현재 경로에서부터 목적지까지 최적 경로를 다시 red 색깔로 칠한다
+    screen.onPlayerFinished = [&](AgentStatus status) {
+        if (status == AgentStatus::Trapped) {
+            std::cout << "Game Over: All paths to the exit are blocked by fire." << std::endl;
+        }
+        else {
+            playerShape.setPosition(nodeMap[exitNodeCode].getPosition()); // 플레이어의 위치를 출구 노드로 설정
+            std::cout << "Player reached the exit!" << std::endl;
+
+            // 경과 시간 계산
+            auto gameEndTime = std::chrono::high_resolution_clock::now(); // 게임 종료 시간을 기록
+            std::chrono::duration<double> gameDuration = gameEndTime - gameStartTime; // 게임 시작 시간부터 종료 시간까지의 경과 시간을 계산
 
-    std::vector<Fire> fireAnimations;
-    std::unordered_set<std::string> passedNodes;
+            std::cout << "Total time taken: " << gameDuration.count() << " seconds" << std::endl;
+            std::cout << "Total weight of the path: " << simulation.totalWeight() << std::endl;
+        }
+        window.close(); // 게임 창을 닫습니다.
+    };
+    simulation.addObserver(screen);
 
     while (window.isOpen()) {
         sf::Event event;
@@ -541,166 +795,68 @@ int main() {
                 window.close();
         }
 
-        // ȭ簡   ó(, ڰ ִ ġ θ ̵  ð Ȯȴ)
-        if (fireClock.getElapsedTime().asSeconds() > 1.0 * maxTravelTime) {
-            fireClock.restart();
-            std::unordered_set<std::string> newFireNodes;
-
-            // ȭ 忡 ؼ,
-            for (const auto& fireNode : fireNodes) {
-                //ȭ    忡  Ȯ
-                for (const auto& node : nodes) {
-                    if (node.code == fireNode) {
-                        for (const auto& neighbor : node.nearNodes) {
-                            if (fireNodes.find(neighbor.first) == fireNodes.end()) {
-                                newFireNodes.insert(neighbor.first);
-
-                                sf::CircleShape fireShape(5);
-                                fireShape.setFillColor(sf::Color::Magenta);
-                                fireShape.setPosition(nodeMap[fireNode].getPosition());
-                                fireAnimations.emplace_back(fireShape, fireNode, neighbor.first);
-                            }
-                        }
-                        break;
-                    }
-                }
-            }
-            //Ȯ ȭ 带 
-            for (const auto& newFireNode : newFireNodes) {
-                fireNodes.insert(newFireNode);
-            }
-
-            // ȭ簡  θ ϴ Ȯ
-            bool pathBlocked = false;
-            for (const auto& node : path) {
-                if (fireNodes.find(node) != fireNodes.end() && passedNodes.find(node) == passedNodes.end()) {
-                    pathBlocked = true;
-                    break;
-                }
-            }
-
-            //  
-            if (pathBlocked) {
-                std::vector<std::string> newPath = dijkstra(nodes, path[currentPathIndex], exitNodeCode, fireNodes);
-                if (newPath.empty()) {
-                    std::cout << "Game Over: All paths to the exit are blocked by fire." << std::endl;
-                    window.close();
-                }
-                //  ʱȭ ,  ο   θ ٽ red  ĥѴ
-                else {
-                    resetPathEdgesColors(path, nodeMap, pathEdgesShapes, sf::Color::White);
-                    path = newPath;
-                    pathEdgesShapes.clear();
-                    for (size_t i = 1; i < path.size(); ++i) {
-                        sf::VertexArray line(sf::Lines, 2);
-                        const auto& startNode = nodeMap[path[i - 1]];
-                        const auto& endNode = nodeMap[path[i]];
-
-                        line[0].position = startNode.getPosition();
-                        line[0].color = sf::Color::Red;
-                        line[1].position = endNode.getPosition();
-                        line[1].color = sf::Color::Red;
-
-                        pathEdgesShapes.push_back(line);
-                    }
-                    currentPathIndex = 0;
-                    interpolation = 0.0;
-                }
-            }
-        }
-
-        // ̵ ð 
-        sf::Time elapsed = clock.restart(); //   ð  ϰ, clock ٽ 
-        double travelTime = getWeight(path[currentPathIndex], path[currentPathIndex + 1], nodes); //  忡   ġ 
-        double normalizedTime = normalizeWeight(travelTime, minWeight, maxWeight, minTravelTime, maxTravelTime); // ġ ȭϿ ̵ ð 
-        interpolation += elapsed.asSeconds() / normalizedTime; //  ð ȭ ̵ ð    
-
-        if (interpolation >= 1.0) { //   1.0 ̸̻   ̵ Ϸ 
-            interpolation = 0.0; //   ʱȭ
-            totalWeight += travelTime; // ̵ Ϸ  ġ ջ
-            passedNodes.insert(path[currentPathIndex]); //  带 ߰Ͽ 
-            currentPathIndex++; //   ε 
-            if (currentPathIndex + 1 >= path.size()) { //    
-                playerShape.setPosition(nodeMap[exitNodeCode].getPosition()); // ÷̾ ġ ⱸ  
-                std::cout << "Player reached the exit!" << std::endl;
-
-                //  ð 
-                auto gameEndTime = std::chrono::high_resolution_clock::now(); //   ð 
-                std::chrono::duration<double> gameDuration = gameEndTime - gameStartTime; //   ð  ð  ð 
-
-                std::cout << "Total time taken: " << gameDuration.count() << " seconds" << std::endl;
-                std::cout << "Total weight of the path: " << totalWeight << std::endl;
-
-                window.close(); //  â ݽϴ.
-            }
-        }
-        else { //   忡   
-            sf::Vector2f startPos = nodeMap[path[currentPathIndex]].getPosition(); //   ġ ´
-            sf::Vector2f endPos = nodeMap[path[currentPathIndex + 1]].getPosition(); //   ġ ´
-            sf::Vector2f delta = endPos - startPos; //      ġ ̸ 
-
-            //  Һ   Ͽ  ġ 
-            sf::Vector2f interpolatedPos(
-                startPos.x + interpolation * delta.x, // X ǥ  
-                startPos.y + interpolation * delta.y // Y ǥ  
-            );
-
-            playerShape.setPosition(interpolatedPos); // ÷̾ ġ  ġ 
+        // 이전 프레임의 시간 간격만큼 화재, 플레이어, 군중을 진행
+        sf::Time elapsed = clock.restart(); // 이전 프레임의 시간 간격을 측정하고, clock을 다시 시작
+        simulation.step(elapsed.asSeconds());
+
+        // 아직 이동 중이면 현재 노드와 다음 노드 사이를 보간한 위치에 플레이어를 그린다 (노드 ID = nodeShapes 인덱스)
+        if (simulation.status() == AgentStatus::Moving) {
+            const std::vector<int>& path = simulation.playerPath();
+            size_t index = simulation.pathPosition();
+            sf::Vector2f startPos = nodeShapes[path[index]].getPosition();
+            sf::Vector2f endPos = nodeShapes[path[index + 1]].getPosition();
+            playerShape.setPosition(startPos + (endPos - startPos) * static_cast<float>(simulation.progress()));
         }
 
-
-        // ȭ ִϸ̼ Ʈ
-        for (auto& fire : fireAnimations) {
-            double fireTravelTime = getWeight(fire.startNode, fire.endNode, nodes) * 1.0; // ȭ簡  忡   ̵ϴ  ɸ ð ġ 
-            double fireNormalizedTime = normalizeWeight(fireTravelTime, minWeight, maxWeight, minTravelTime, maxTravelTime); // ġ ȭϿ ̵ ð 
-            fire.interpolation += elapsed.asSeconds() / fireNormalizedTime; //  ð ȭ ̵ ð    
-
-            if (fire.interpolation >= 1.0) { //   1.0 ̸̻ ȭ簡  忡  ǹ
-                fire.interpolation = 1.0; //   1.0 Ͽ  忡 Ȯ ϵ Ѵ
-                nodeMap[fire.endNode].setFillColor(sf::Color::Magenta); //  带 ȫ Ͽ ȭ簡 ߻ ǥ
-            }
-
-            sf::Vector2f fireStartPos = nodeMap[fire.startNode].getPosition(); //   ġ ´
-            sf::Vector2f fireEndPos = nodeMap[fire.endNode].getPosition(); //   ġ ´
-            sf::Vector2f fireDelta = fireEndPos - fireStartPos; //      ġ ̸ 
-
-            //  Һ   Ͽ  ġ .
-            sf::Vector2f fireInterpolatedPos(
-                fireStartPos.x + fire.interpolation * fireDelta.x, // X ǥ  
-                fireStartPos.y + fire.interpolation * fireDelta.y // Y ǥ  
-            );
-
-            fire.shape.setPosition(fireInterpolatedPos); // ȭ ִϸ̼ ġ  ġ .
-        }
+        // 화재 애니메이션 업데이트 (끝 노드에 도달한 애니메이션은 노드를 자홍색으로 칠하고 저장소에서 지운다)
+        fireAnimations.update(elapsed.asSeconds(), [&](int target) {
+            nodeShapes[target].setFillColor(sf::Color::Magenta);
+        });
 
 
         window.clear();
 
-        //   ׸
+        // 모든 간선 그리기
         for (const auto& edge : edgesShapes) {
             window.draw(edge);
         }
 
-        //   ׸
+        // 경로 간선 그리기
         for (const auto& edge : pathEdgesShapes) {
             window.draw(edge);
         }
 
-        //   ׸
+        // 모든 노드 그리기
         for (const auto& shape : nodeShapes) {
             window.draw(shape);
         }
 
-        // ÷̾ ׸
+        // 플레이어 그리기
         window.draw(playerShape);
 
-        // ȭ ִϸ̼ ׸
-        for (const auto& fire : fireAnimations) {
-            window.draw(fire.shape);
+        // 이동 중인 군중 에이전트 그리기 (위치는 커널로 한꺼번에 보간, 노드 위에서 다음 간선을 기다리는 에이전트는 노드 위치)
+        crowd.positions(nodeX, nodeY, agentX, agentY);
+        for (int i = 0; i < crowd.size(); ++i) {
+            if (crowd.status(i) != CrowdStatus::Moving) continue;
+            agentShape.setPosition(agentX[i], agentY[i]);
+            window.draw(agentShape);
+        }
+
+        // 화재 애니메이션 그리기 (노드 ID는 nodeShapes의 위치와 같다)
+        for (size_t i = 0; i < fireAnimations.size(); ++i) {
+            sf::Vector2f fireStartPos = nodeShapes[fireAnimations.source(i)].getPosition(); // 시작 노드의 위치를 가져온다
+            sf::Vector2f fireEndPos = nodeShapes[fireAnimations.target(i)].getPosition(); // 끝 노드의 위치를 가져온다
+            float t = fireAnimations.progress(i);
+            fireShape.setPosition(fireStartPos + (fireEndPos - fireStartPos) * t); // 진행률만큼 보간한 위치
+            window.draw(fireShape);
         }
 
         window.display();
     }
 
+    if (crowd.size() > 0) {
+        std::cout << "Agents: " << crowd.size() << ", escaped: " << crowd.escaped() << ", trapped: " << crowd.trapped() << std::endl;
+    }
+
     return 0;
-}
\ No newline at end of file
+}
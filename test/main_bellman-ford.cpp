@@ -200,7 +200,7 @@ int main() {
 
     // // 다이익스트라 알고리즘으로 경로 찾기
     // std::vector<std::string> path = dijkstra(nodes, playerNodeCode, exitNodeCode, fireNodes);
-    // edmonds-karp 알고리즘으로 경로 찾기
+    // 벨만-포드 알고리즘으로 경로 찾기
     std::vector<std::string> path = bellmanFord(nodes, playerNodeCode, exitNodeCode, fireNodes);
 
     // 최소 및 최대 가중치 찾기
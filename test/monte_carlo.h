@@ -0,0 +1,157 @@
+#pragma once
+
+#include <vector>
+#include <string>
+#include <fstream>
+#include <thread>
+#include <atomic>
+#include <limits>
+#include <cstdint>
+#include <algorithm>
+
+#include "graph.h"
+#include "node_bitset.h"
+#include "pathfinding.h"
+#include "stochastic_fire.h"
+#include "event_simulation.h"
+#include "thread_pool.h"
+#include "random.h"
+
+// 시나리오 한 번의 결과 종류
+enum class EscapeResult {
+    Escaped,  // 탈출 성공
+    NoInitialPath,  // 처음부터 탈출구로 가는 경로가 없음
+    Trapped,  // 이동 중 모든 경로가 화재로 막힘
+    TimeLimit  // 제한 시간 안에 탈출하지 못함
+};
+
+// 몬테카를로 시뮬레이션 설정
+struct MonteCarloConfig {
+    int runs = 1000;  // 시나리오 수
+    int threads = 0;  // 작업 스레드 수 (0이면 하드웨어 스레드 수)
+    std::uint64_t seed = 0;  // 시나리오 난수의 기본 시드
+    FireSpreadConfig spread;  // 간선별 화재 위험률 설정
+    double fireTick = 3.0;  // 화재 확산 주기 (초)
+    double timeLimit = 3600.0;  // 시나리오 최대 시뮬레이션 시간 (초)
+};
+
+// 시나리오 한 번의 결과
+struct ScenarioResult {
+    int startId;
+    int ignitionId;
+    EscapeResult result;
+    double escapeTime;  // 탈출에 걸린 시뮬레이션 시간 (탈출한 경우)
+    int replans;  // 경로 재계산 횟수
+};
+
+// 임의의 발화 지점과 시작 노드에서 화면 없이 탈출 과정을 한 번 시뮬레이션하는 함수
+// 플레이어는 travelTimes[e]초에 걸쳐 간선 e를 지나고, 불은 fireTick초마다 간선별 위험률에 따라 확률적으로 번진다 (fireModel).
+// 아직 지나지 않은 경로 노드에 불이 붙으면 현재 노드에서 다익스트라로 경로를 다시 찾는다 (게임 화면과 같은 규칙)
+// 화재 틱과 간선 도착을 이벤트 시뮬레이션으로 처리한다
+inline ScenarioResult runScenario(const Graph& graph, const std::vector<double>& travelTimes, int exitId,
+    const StochasticFireModel& fireModel, const MonteCarloConfig& config, Random& rng) {
+    int n = graph.size();
+    ScenarioResult result;
+    result.ignitionId = rng.below(n);
+    do {
+        result.startId = rng.below(n);
+    } while (result.startId == exitId && n > 1);
+    result.escapeTime = 0.0;
+    result.replans = 0;
+
+    LaneRandom fireRng(rng.next());
+
+    // 이벤트 시뮬레이션: 화재 틱과 간선 도착만 처리하므로 프레임을 흉내 낼 필요가 없다
+    EventSimulation simulation(graph, travelTimes, exitId, [&](int from, double, const NodeBitset& fireNodes) {
+        return dijkstra(graph, from, exitId, fireNodes);
+    });
+    simulation.useStochasticFire(fireModel, fireRng, config.fireTick);
+    simulation.ignite(result.ignitionId);
+    simulation.addAgent(result.startId);
+    simulation.runUntil(config.timeLimit);
+
+    const Agent& agent = simulation.agentList()[0];
+    result.replans = agent.replans;
+    switch (agent.status) {
+    case AgentStatus::Escaped:
+        result.result = EscapeResult::Escaped;
+        result.escapeTime = agent.escapeTime;
+        break;
+    case AgentStatus::NoInitialPath:
+        result.result = EscapeResult::NoInitialPath;
+        break;
+    case AgentStatus::Trapped:
+        result.result = EscapeResult::Trapped;
+        break;
+    case AgentStatus::Moving:
+        result.result = EscapeResult::TimeLimit;
+        break;
+    }
+    return result;
+}
+
+// 시나리오들을 모든 코어에 나누어 병렬로 실행하는 함수
+// 시나리오 i는 seed의 i번째 스트림을 쓰므로 스레드 수와 관계없이 결과가 같다
+inline std::vector<ScenarioResult> runMonteCarlo(const Graph& graph, const std::vector<double>& travelTimes, int exitId, const MonteCarloConfig& config) {
+    std::vector<ScenarioResult> results(config.runs);
+    int threadCount = config.threads > 0 ? config.threads : static_cast<int>(std::thread::hardware_concurrency());
+    threadCount = std::max(1, std::min(threadCount, config.runs));
+
+    // 간선별 확산 확률은 모든 시나리오가 공유한다
+    StochasticFireModel fireModel(graph, config.spread, config.fireTick);
+
+    std::atomic<int> nextScenario(0);
+    auto worker = [&]() {
+        for (int i = nextScenario++; i < config.runs; i = nextScenario++) {
+            Random rng(config.seed, static_cast<std::uint64_t>(i));
+            results[i] = runScenario(graph, travelTimes, exitId, fireModel, config, rng);
+        }
+    };
+
+    // threadCount개의 작업이 남은 시나리오를 하나씩 가져가며 실행한다 (시나리오 길이가 달라도 먼저 끝난 작업이 더 가져간다)
+    TaskGroup group(sharedPool());
+    for (int t = 1; t < threadCount; ++t) {
+        group.run(worker);
+    }
+    worker();
+    group.wait();
+    return results;
+}
+
+// 시작 노드별 탈출 확률, 평균 탈출 시간, 실패 원인을 CSV 파일로 저장하는 함수
+inline bool writeMonteCarloCSV(const std::string& filename, const Graph& graph, const std::vector<ScenarioResult>& results) {
+    std::ofstream file(filename);
+    if (!file) return false;
+
+    int n = graph.size();
+    std::vector<int> runs(n, 0), escaped(n, 0), noInitialPath(n, 0), trapped(n, 0), timeLimit(n, 0);
+    std::vector<double> escapeTimeSum(n, 0.0);
+    for (const auto& result : results) {
+        runs[result.startId]++;
+        switch (result.result) {
+        case EscapeResult::Escaped:
+            escaped[result.startId]++;
+            escapeTimeSum[result.startId] += result.escapeTime;
+            break;
+        case EscapeResult::NoInitialPath:
+            noInitialPath[result.startId]++;
+            break;
+        case EscapeResult::Trapped:
+            trapped[result.startId]++;
+            break;
+        case EscapeResult::TimeLimit:
+            timeLimit[result.startId]++;
+            break;
+        }
+    }
+
+    file << "node,runs,escaped,escape_probability,mean_escape_time,no_initial_path,trapped,time_limit\n";
+    for (int id = 0; id < n; ++id) {
+        if (runs[id] == 0) continue;
+        file << graph.codes[id] << ',' << runs[id] << ',' << escaped[id] << ','
+            << static_cast<double>(escaped[id]) / runs[id] << ','
+            << (escaped[id] > 0 ? escapeTimeSum[id] / escaped[id] : 0.0) << ','
+            << noInitialPath[id] << ',' << trapped[id] << ',' << timeLimit[id] << '\n';
+    }
+    return true;
+}
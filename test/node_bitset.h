@@ -0,0 +1,86 @@
+#pragma once
+
+#include <vector>
+#include <cstdint>
+#include <algorithm>
+
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif
+
+// 64비트 워드 안에서 가장 낮은 1비트의 위치를 구하는 함수
+inline int lowestBit(std::uint64_t word) {
+#ifdef _MSC_VER
+    unsigned long index;
+    _BitScanForward64(&index, word);
+    return static_cast<int>(index);
+#else
+    return __builtin_ctzll(word);
+#endif
+}
+
+// 노드 ID를 비트 위치로 쓰는 고정 크기 비트셋 (화재, 지나온 노드, 방문 여부 등의 상태 저장)
+// 문자열 해시 대신 비트 검사 한 번으로 상태를 확인하고, 합집합/교집합 검사는 64개 노드씩 한 번에 처리한다
+class NodeBitset {
+public:
+    NodeBitset() : count(0) {}
+    explicit NodeBitset(int size) : words((size + 63) / 64, 0), count(size) {}
+
+    int size() const { return count; }
+
+    bool test(int id) const { return (words[id >> 6] >> (id & 63)) & 1; }
+    void set(int id) { words[id >> 6] |= std::uint64_t(1) << (id & 63); }
+    void reset(int id) { words[id >> 6] &= ~(std::uint64_t(1) << (id & 63)); }
+    void clear() { std::fill(words.begin(), words.end(), 0); }
+
+    // 비트가 새로 켜졌으면 참을 반환하는 함수
+    bool insert(int id) {
+        std::uint64_t mask = std::uint64_t(1) << (id & 63);
+        bool added = !(words[id >> 6] & mask);
+        words[id >> 6] |= mask;
+        return added;
+    }
+
+    // 합집합
+    NodeBitset& operator|=(const NodeBitset& other) {
+        for (size_t i = 0; i < words.size(); ++i) words[i] |= other.words[i];
+        return *this;
+    }
+
+    // 두 집합에 공통 노드가 있는지 검사
+    bool intersects(const NodeBitset& other) const {
+        for (size_t i = 0; i < words.size(); ++i) {
+            if (words[i] & other.words[i]) return true;
+        }
+        return false;
+    }
+
+    // excluded에 속하지 않는 공통 노드가 있는지 검사 (예: 아직 지나지 않은 경로 노드 중 불타는 노드)
+    bool intersectsExcluding(const NodeBitset& other, const NodeBitset& excluded) const {
+        for (size_t i = 0; i < words.size(); ++i) {
+            if (words[i] & other.words[i] & ~excluded.words[i]) return true;
+        }
+        return false;
+    }
+
+    bool any() const {
+        for (std::uint64_t word : words) {
+            if (word) return true;
+        }
+        return false;
+    }
+
+    // 켜진 비트마다 fn(id)를 호출하는 함수
+    template <typename Fn>
+    void forEach(Fn fn) const {
+        for (size_t i = 0; i < words.size(); ++i) {
+            for (std::uint64_t word = words[i]; word; word &= word - 1) {
+                fn(static_cast<int>(i * 64) + lowestBit(word));
+            }
+        }
+    }
+
+private:
+    std::vector<std::uint64_t> words;
+    int count;
+};
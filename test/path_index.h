@@ -0,0 +1,68 @@
+#pragma once
+
+#include <vector>
+
+#include "node_bitset.h"
+
+// 현재 경로에 노드가 들어 있는지와 그 위치를 노드 ID로 바로 찾는 인덱스
+// 새로 불붙은 노드만 이 인덱스로 확인하면 되므로 경로 전체를 매 틱마다 훑지 않아도 된다
+class PathIndex {
+public:
+    explicit PathIndex(int nodeCount) : members(nodeCount), positions(nodeCount, -1) {}
+
+    // 경로를 바꾸는 함수 (이전 경로의 노드만 지우므로 비용은 두 경로의 길이에 비례한다)
+    void assign(const std::vector<int>& path) {
+        for (int id : nodes) {
+            members.reset(id);
+        }
+        nodes = path;
+        for (size_t i = 0; i < nodes.size(); ++i) {
+            members.set(nodes[i]);
+            positions[nodes[i]] = static_cast<int>(i);
+        }
+    }
+
+    bool contains(int id) const { return members.test(id); }
+
+    // 경로에서 노드의 위치 (경로에 없으면 -1)
+    int position(int id) const { return members.test(id) ? positions[id] : -1; }
+
+private:
+    NodeBitset members;  // 경로에 들어 있는 노드
+    std::vector<int> positions;  // 노드 ID별 경로상 위치 (members에 있는 노드만 유효)
+    std::vector<int> nodes;  // 현재 경로
+};
+
+// 노드 ID -> 그 노드를 경로에 가진 에이전트들의 역색인
+// 노드에 불이 붙으면 그 노드의 목록만 꺼내 보면 영향을 받는 에이전트를 모두 찾을 수 있다.
+// 경로가 바뀌어도 이전 항목을 지우지 않고 경로 버전으로 무효 여부를 판단하며, 노드는 한 번만 불붙으므로 꺼낸 목록은 비운다.
+class RouteIndex {
+public:
+    struct Entry {
+        int agent;
+        int version;  // 항목을 추가할 때의 에이전트 경로 버전
+        int position;  // 경로상 위치
+    };
+
+    explicit RouteIndex(int nodeCount) : entries(nodeCount) {}
+
+    // 에이전트의 새 경로를 색인에 추가하는 함수
+    void add(int agent, int version, const std::vector<int>& path) {
+        for (size_t i = 0; i < path.size(); ++i) {
+            entries[path[i]].push_back({ agent, version, static_cast<int>(i) });
+        }
+    }
+
+    // 노드를 경로에 가진 모든 항목에 fn(entry)를 호출하고 노드의 목록을 비우는 함수
+    template <typename EntryFn>
+    void take(int id, EntryFn fn) {
+        std::vector<Entry> list;
+        list.swap(entries[id]);
+        for (const Entry& entry : list) {
+            fn(entry);
+        }
+    }
+
+private:
+    std::vector<std::vector<Entry>> entries;  // 노드 ID별 항목
+};
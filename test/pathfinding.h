@@ -0,0 +1,203 @@
+#pragma once
+
+#include <vector>
+#include <queue>
+#include <limits>
+#include <cmath>
+#include <functional>
+#include <utility>
+#include <algorithm>
+
+#include "graph.h"
+#include "node_bitset.h"
+
+// 다익스트라 알고리즘을 사용하여 최단 경로를 찾는 함수
+inline std::vector<int> dijkstra(const Graph& graph, int startId, int exitId, const NodeBitset& fireNodes) {
+    std::vector<double> distances(graph.size(), std::numeric_limits<double>::infinity());
+    std::vector<int> previous(graph.size(), -1);
+    NodeBitset visited(graph.size());
+    //우선순위 큐 선언 (거리, 노드 ID)
+    typedef std::pair<double, int> Entry;
+    std::priority_queue<Entry, std::vector<Entry>, std::greater<Entry>> queue;
+
+    //시작노드의 거리를 0으로 설정 후 우선순위 큐에 삽입
+    distances[startId] = 0;
+    queue.push({ 0.0, startId });
+
+    while (!queue.empty()) {
+        int current = queue.top().second;
+        queue.pop();
+
+        if (!visited.insert(current)) continue; // 이미 확정된 노드는 건너뜀
+        if (current == exitId) break;
+
+        for (int e = graph.offsets[current]; e < graph.offsets[current + 1]; ++e) {
+            int neighbor = graph.targets[e];
+            if (fireNodes.test(neighbor)) {
+                continue; // 화재가 발생한 노드로 이동하지 않음
+            }
+            double alt = distances[current] + graph.weights[e];
+            if (alt < distances[neighbor]) {
+                distances[neighbor] = alt;
+                previous[neighbor] = current;
+                queue.push({ alt, neighbor });
+            }
+        }
+    }
+
+    //목표 노드부터 시작 노드까지 previous 배열을 사용하여 경로를 추적한다. 이후, 추적한 경로를 뒤집어서 최단 경로로 반환한다.
+    std::vector<int> path;
+    if (distances[exitId] == std::numeric_limits<double>::infinity()) {
+        return {}; // 경로가 없는 경우 빈 벡터 반환
+    }
+    for (int at = exitId; at != -1; at = previous[at]) {
+        path.push_back(at);
+    }
+    std::reverse(path.begin(), path.end());
+    return path;
+}
+
+
+// bellman-ford 알고리즘을 사용하여 최단 경로를 찾는 함수
+inline std::vector<int> bellmanFord(const Graph& graph, int startId, int exitId, const NodeBitset& fireNodes) {
+    int n = graph.size();
+    std::vector<double> distances(n, std::numeric_limits<double>::infinity());
+    std::vector<int> previous(n, -1);
+    distances[startId] = 0.0;
+
+    for (int i = 0; i < n - 1; ++i) {     // (정점 개수 - 1)번 반복
+        bool updated = false;
+        for (int u = 0; u < n; ++u) {
+            if (distances[u] == std::numeric_limits<double>::infinity()) continue;
+            for (int e = graph.offsets[u]; e < graph.offsets[u + 1]; ++e) {
+                int v = graph.targets[e];
+                if (fireNodes.test(v)) continue; // 화재가 발생한 노드로는 이동하지 않음
+                // 지금까지의 v까지의 거리보다 현재 u를 거친 v까지의 거리가 더 작을 경우 업데이트
+                if (distances[v] > distances[u] + graph.weights[e]) {
+                    distances[v] = distances[u] + graph.weights[e];
+                    previous[v] = u;
+                    updated = true;
+                }
+            }
+        }
+        if (!updated) break; // 더 이상 갱신이 없으면 조기 종료
+    }
+
+    // 출구로 가는 경로가 없는 경우
+    if (distances[exitId] == std::numeric_limits<double>::infinity()) {
+        return {};
+    }
+
+    std::vector<int> path;
+    for (int at = exitId; at != -1; at = previous[at]) {
+        path.push_back(at);
+    }
+    std::reverse(path.begin(), path.end());
+    return path;
+}
+
+// 플로이드워셜 알고리즘을 사용하여 최단 경로를 찾는 함수
+inline std::vector<int> floydWarshall(const Graph& graph, int startId, int exitId, const NodeBitset& fireNodes) {
+    int n = graph.size();
+
+    // 거리 행렬 초기화
+    std::vector<std::vector<double>> dist(n, std::vector<double>(n, std::numeric_limits<double>::infinity()));
+    std::vector<std::vector<int>> next(n, std::vector<int>(n, -1));
+
+    for (int i = 0; i < n; ++i) {
+        dist[i][i] = 0;
+        next[i][i] = i;
+    }
+
+    for (int u = 0; u < n; ++u) {
+        for (int e = graph.offsets[u]; e < graph.offsets[u + 1]; ++e) {
+            int v = graph.targets[e];
+            if (!fireNodes.test(v)) { // 화재가 발생한 노드로의 간선 제외
+                dist[u][v] = graph.weights[e];
+                next[u][v] = v;
+            }
+        }
+    }
+
+    // 플로이드-워셜 알고리즘 수행
+    for (int k = 0; k < n; ++k) {
+        for (int i = 0; i < n; ++i) {
+            for (int j = 0; j < n; ++j) {
+                if (dist[i][k] + dist[k][j] < dist[i][j]) {
+                    dist[i][j] = dist[i][k] + dist[k][j];
+                    next[i][j] = next[i][k];
+                }
+            }
+        }
+    }
+
+    // 경로 재구성
+    std::vector<int> path;
+    int u = startId;
+    int v = exitId;
+
+    if (next[u][v] == -1) {
+        // 경로가 존재하지 않음
+        return path;
+    }
+
+    while (u != v) {
+        path.push_back(u);
+        u = next[u][v];
+    }
+    path.push_back(v);
+
+    return path;
+}
+
+// A* 알고리즘에 사용할 휴리스틱 함
+// 두 노드 간의 유클리드 거리를 계산하여 반환
+inline double heuristic(const Graph& graph, int a, int b) {
+    return std::sqrt((graph.latitudes[a] - graph.latitudes[b]) * (graph.latitudes[a] - graph.latitudes[b]) +
+        (graph.longitudes[a] - graph.longitudes[b]) * (graph.longitudes[a] - graph.longitudes[b]));
+}
+
+//A* 알고리즘을 이용하여 최단 경로를 찾는 함수
+inline std::vector<int> astar(const Graph& graph, int startId, int exitId, const NodeBitset& fireNodes) {
+    std::vector<double> gScore(graph.size(), std::numeric_limits<double>::infinity()); // 시작 노드에서 특정 노드까지의 실제 비용
+    std::vector<int> cameFrom(graph.size(), -1); // 각 노드의 이전 노드를 저장하여 경로를 재구성
+    NodeBitset closedSet(graph.size()); // 이미 확정된 노드
+    // 우선순위 큐를 사용하여 fScore(gScore + 휴리스틱)가 낮은 노드를 우선 탐색
+    typedef std::pair<double, int> Entry;
+    std::priority_queue<Entry, std::vector<Entry>, std::greater<Entry>> openSet;
+
+    gScore[startId] = 0.0; // 시작 노드의 gScore는 0
+    openSet.push({ heuristic(graph, startId, exitId), startId }); // 시작 노드를 우선순위 큐에 추가
+
+    while (!openSet.empty()) {
+        int current = openSet.top().second; // fScore가 가장 낮은 노드를 선택
+        openSet.pop();
+
+        if (current == exitId) { // 목표 노드에 도달한 경우 경로를 재구성하여 반환
+            std::vector<int> path;
+            for (int at = exitId; at != -1; at = cameFrom[at]) {
+                path.push_back(at);
+            }
+            std::reverse(path.begin(), path.end()); // 경로를 역순으로 구성했으므로 순서를 반대로 변경
+            return path;
+        }
+        if (!closedSet.insert(current)) continue; // 이미 확정된 노드는 건너뜀
+
+        //현재 노드의 모든 인접 노드를 탐색
+        for (int e = graph.offsets[current]; e < graph.offsets[current + 1]; ++e) {
+            int neighbor = graph.targets[e];
+            if (fireNodes.test(neighbor)) {
+                continue; //화재가 발생한 노드는 탐색하지 않음
+            }
+            double tentative_gScore = gScore[current] + graph.weights[e]; // 새로운 gScore 계산
+            if (tentative_gScore < gScore[neighbor]) { // 더 나은 gScore를 발견한 경우 갱신
+                cameFrom[neighbor] = current; // 경로를 재구성하기 위해 이전 노드 저장
+                gScore[neighbor] = tentative_gScore;
+                // fScore 갱신: gScore + 휴리스틱 후 인접 노드를 우선순위 큐에 추가함
+                openSet.push({ tentative_gScore + heuristic(graph, neighbor, exitId), neighbor });
+            }
+        }
+    }
+
+    return {}; //목표 노드에 도달할 수 없는 경우 빈 벡터 반환
+}
@@ -0,0 +1,284 @@
+#pragma once
+
+#include <vector>
+#include <string>
+#include <memory>
+#include <functional>
+#include <chrono>
+#include <limits>
+#include <utility>
+
+#include "graph.h"
+#include "node_bitset.h"
+#include "pathfinding.h"
+#include "dynamic_sssp.h"
+#include "k_shortest_paths.h"
+#include "fire.h"
+#include "time_aware_route.h"
+#include "thread_pool.h"
+
+// 경로 탐색기 설정
+struct PlannerConfig {
+    int fallbackRouteCount = 3;  // 갈림길 노드마다 미리 계산할 대체 경로 수 (대체 경로를 쓰는 탐색기만)
+    bool precomputeFallbacks = true;  // 대체 경로를 스레드 풀에서 미리 계산 (false면 경로가 막힌 노드의 대체 경로만 그때 계산하며, 결과는 같다)
+};
+
+// 경로 탐색기가 읽는 시뮬레이션의 현재 상태 (탐색기는 읽기만 한다)
+struct PlanContext {
+    const Graph* graph;
+    const std::vector<double>* travelTimes;  // 간선별 이동 시간 (초)
+    const std::vector<int>* exits;  // 탈출구 (이동 시간이 가장 짧은 경로가 있는 탈출구로 간다)
+    const NodeBitset* burningNodes;  // 지금 불타는 노드
+    const FireField* fireField;  // 각 노드에 불이 도달하는 시각
+    double fireTime;  // 현재 화재 시각 (초)
+    const std::vector<ExitTree>* exitTrees;  // 탈출구별 최단 경로 트리 (연기와 혼잡 비용 반영)
+    TaskGroup* background;  // prepare에서 넣은 미리 계산 작업 (탐색기는 쓸 결과만 확인하고, 스냅샷을 만들 때 모두 기다린다)
+};
+
+// 경로 탐색기의 누적 통계 (처음 경로와 다시 찾은 경로를 나눠 센다)
+struct PlannerStats {
+    int plans = 0;  // 처음 경로를 찾은 횟수
+    int replans = 0;  // 경로가 막혀 다시 찾은 횟수
+    int failures = 0;  // 경로를 찾지 못한 횟수
+    double planSeconds = 0.0;  // 처음 경로를 찾는 데 걸린 실제 시간의 합 (초)
+    double replanSeconds = 0.0;  // 경로를 다시 찾는 데 걸린 실제 시간의 합 (초)
+};
+
+// 탈출구마다 route(탈출구 번호)로 경로를 찾아 이동 시간이 가장 짧은 경로를 고르는 함수 (모두 없으면 빈 경로)
+template <typename RouteFn>
+std::vector<int> nearestRoute(const PlanContext& context, RouteFn route) {
+    std::vector<int> best;
+    double bestTime = std::numeric_limits<double>::infinity();
+    for (size_t i = 0; i < context.exits->size(); ++i) {
+        std::vector<int> candidate = route(i);
+        if (candidate.empty()) continue;
+        double time = 0.0;
+        for (size_t k = 0; k + 1 < candidate.size(); ++k) {
+            time += (*context.travelTimes)[context.graph->edge(candidate[k], candidate[k + 1])];
+        }
+        if (time < bestTime) {
+            bestTime = time;
+            best.swap(candidate);
+        }
+    }
+    return best;
+}
+
+// 플레이어의 경로를 찾는 탐색기 (처음 경로와 경로가 막혔을 때 다시 찾는 경로를 같은 탐색기가 맡는다)
+// plan과 replan이 걸린 시간과 횟수를 세므로, 탐색기끼리 처음부터 끝까지 같은 조건으로 비교할 수 있다.
+// 탐색기는 시뮬레이션과 함께 스냅샷에 담기므로, 상태를 가진 탐색기는 clone으로 그 상태를 복사해야 한다.
+class Planner {
+public:
+    virtual ~Planner() {}
+
+    // start에서 탈출구까지의 처음 경로 (없으면 빈 경로)
+    std::vector<int> plan(const PlanContext& context, int start) {
+        auto startTime = std::chrono::steady_clock::now();
+        std::vector<int> path = computePlan(context, start);
+        counters.plans++;
+        counters.planSeconds += std::chrono::duration<double>(std::chrono::steady_clock::now() - startTime).count();
+        if (path.empty()) counters.failures++;
+        return path;
+    }
+
+    // 경로가 막혀 from에서 다시 찾는 경로 (없으면 빈 경로)
+    std::vector<int> replan(const PlanContext& context, int from) {
+        auto startTime = std::chrono::steady_clock::now();
+        std::vector<int> path = computeReplan(context, from);
+        counters.replans++;
+        counters.replanSeconds += std::chrono::duration<double>(std::chrono::steady_clock::now() - startTime).count();
+        if (path.empty()) counters.failures++;
+        return path;
+    }
+
+    const PlannerStats& stats() const { return counters; }
+
+    // 시뮬레이션을 시작할 때 한 번 부르는 함수 (미리 계산할 것이 있으면 background에 넣는다)
+    virtual void prepare(const PlanContext&) {}
+
+    // 같은 상태의 사본 (prepare로 넣은 작업이 끝난 뒤에만 부른다)
+    virtual std::shared_ptr<Planner> clone() const = 0;
+
+protected:
+    virtual std::vector<int> computePlan(const PlanContext& context, int start) = 0;
+
+    // 기본은 처음 경로와 같은 방법으로 from에서 다시 찾는다
+    virtual std::vector<int> computeReplan(const PlanContext& context, int from) {
+        return computePlan(context, from);
+    }
+
+private:
+    PlannerStats counters;
+};
+
+// 탐색기를 CopyOnWrite로 들고 있을 때 쓰는 복사 방법 (파생 클래스의 상태까지 복사한다)
+struct ClonePlanner {
+    std::shared_ptr<Planner> operator()(const Planner& planner) const { return planner.clone(); }
+};
+
+// 지금 불타는 노드만 피하는 최단 경로 탐색기 (pathfinding.h의 알고리즘 하나로 처음 경로와 다시 찾는 경로를 모두 찾는다)
+class BlockedNodePlanner : public Planner {
+public:
+    typedef std::vector<int> (*SearchFn)(const Graph& graph, int startId, int exitId, const NodeBitset& fireNodes);
+
+    explicit BlockedNodePlanner(SearchFn search) : search(search) {}
+
+    std::shared_ptr<Planner> clone() const override { return std::make_shared<BlockedNodePlanner>(*this); }
+
+protected:
+    std::vector<int> computePlan(const PlanContext& context, int start) override {
+        return nearestRoute(context, [&](size_t i) {
+            return search(*context.graph, start, (*context.exits)[i], *context.burningNodes);
+        });
+    }
+
+private:
+    SearchFn search;
+};
+
+// 시뮬레이션이 화재와 연기, 혼잡에 맞춰 고쳐 두는 탈출구 트리를 따라가는 탐색기 (경로를 찾을 때 새로 탐색하지 않는다)
+class ExitTreePlanner : public Planner {
+public:
+    std::shared_ptr<Planner> clone() const override { return std::make_shared<ExitTreePlanner>(*this); }
+
+protected:
+    std::vector<int> computePlan(const PlanContext& context, int start) override {
+        return nearestRoute(context, [&](size_t i) { return (*context.exitTrees)[i].pathFrom(start); });
+    }
+};
+
+// 화재 도달 시각을 고려하는 탐색기 (기본)
+// 처음에는 불보다 먼저 지나갈 수 있는 경로를 찾고, 그런 경로가 없으면 지금 불타는 노드만 피하는 최단 경로로 대신한다.
+// 경로가 막히면 현재 시각 기준으로 다시 찾고, 없으면 미리 계산한 대체 경로 중 아직 불타지 않은 첫 번째 경로,
+// 그것도 모두 막혔을 때만 연기 비용을 반영한 탈출구 트리를 따른다.
+class TimeAwarePlanner : public Planner {
+public:
+    explicit TimeAwarePlanner(const PlannerConfig& config) : config(config) {}
+
+    // 갈림길 노드마다 탈출구까지의 대체 경로를 스레드 풀에서 낮은 우선순위로 미리 계산한다
+    // (경로가 막힌 노드의 계산이 아직 끝나지 않았으면 그 노드만 바로 계산하므로 다른 노드의 계산을 기다리지 않는다)
+    void prepare(const PlanContext& context) override {
+        initialFire = *context.burningNodes;
+        fallbacks.assign(context.exits->size(), FallbackRoutes());
+        ready = NodeBitset(context.graph->size());
+        if (!config.precomputeFallbacks) return;
+        for (size_t i = 0; i < context.exits->size(); ++i) {
+            fallbacks[i].precompute(*context.graph, (*context.exits)[i], config.fallbackRouteCount, initialFire, *context.background);
+        }
+    }
+
+    std::shared_ptr<Planner> clone() const override { return std::make_shared<TimeAwarePlanner>(*this); }
+
+protected:
+    std::vector<int> computePlan(const PlanContext& context, int start) override {
+        std::vector<int> path = timeAware(context, start);
+        if (path.empty()) {
+            path = nearestRoute(context, [&](size_t i) { return dijkstra(*context.graph, start, (*context.exits)[i], *context.burningNodes); });
+        }
+        return path;
+    }
+
+    std::vector<int> computeReplan(const PlanContext& context, int from) override {
+        std::vector<int> path = timeAware(context, from);
+        if (path.empty()) {
+            path = nearestRoute(context, [&](size_t i) {
+                const RoutePath* fallback = fallbacksFrom(context, from, i).firstFireFree(from, [&](int id) {
+                    return context.burningNodes->test(id);
+                });
+                return fallback ? fallback->nodes : std::vector<int>();
+            });
+        }
+        if (path.empty()) {
+            path = nearestRoute(context, [&](size_t i) { return (*context.exitTrees)[i].pathFrom(from); });
+        }
+        return path;
+    }
+
+private:
+    // 현재 화재 시각에 from을 출발해 불보다 먼저 지나갈 수 있는 경로
+    static std::vector<int> timeAware(const PlanContext& context, int from) {
+        const std::vector<double>& travelTimes = *context.travelTimes;
+        return nearestRoute(context, [&](size_t i) {
+            return timeAwareRoute(*context.graph, from, (*context.exits)[i], *context.fireField, context.fireTime,
+                [&travelTimes](int e) { return travelTimes[e]; });
+        });
+    }
+
+    // 탈출구 번호(exits의 인덱스)의 대체 경로 저장소를 반환하는 함수
+    // 미리 계산 중이면 node의 계산만 끝나기를 기다리고, 미리 계산하지 않았으면 node의 대체 경로를 처음 찾을 때 계산한다
+    const FallbackRoutes& fallbacksFrom(const PlanContext& context, int node, size_t exitIndex) {
+        if (config.precomputeFallbacks) {
+            fallbacks[exitIndex].awaitNode(node);
+        }
+        else if (!ready.test(node)) {
+            for (size_t i = 0; i < context.exits->size(); ++i) {
+                fallbacks[i].computeNode(*context.graph, node, (*context.exits)[i], config.fallbackRouteCount, initialFire);
+            }
+            ready.set(node);
+        }
+        return fallbacks[exitIndex];
+    }
+
+    PlannerConfig config;
+    std::vector<FallbackRoutes> fallbacks;  // 탈출구별 대체 경로
+    NodeBitset ready;  // 대체 경로를 계산한 노드 (미리 계산하지 않을 때)
+    NodeBitset initialFire;  // 대체 경로가 피하는 노드 (시작할 때 불타던 노드)
+};
+
+// 이름으로 탐색기를 만드는 함수
+typedef std::function<std::shared_ptr<Planner>(const PlannerConfig& config)> PlannerFactory;
+
+// 등록된 탐색기 (처음 쓸 때 기본 탐색기를 등록한다, 등록 순서대로)
+inline std::vector<std::pair<std::string, PlannerFactory>>& plannerRegistry() {
+    static std::vector<std::pair<std::string, PlannerFactory>> registry = {
+        { "time-aware", [](const PlannerConfig& config) { return std::make_shared<TimeAwarePlanner>(config); } },
+        { "dijkstra", [](const PlannerConfig&) { return std::make_shared<BlockedNodePlanner>(&dijkstra); } },
+        { "bellman-ford", [](const PlannerConfig&) { return std::make_shared<BlockedNodePlanner>(&bellmanFord); } },
+        { "floyd-warshall", [](const PlannerConfig&) { return std::make_shared<BlockedNodePlanner>(&floydWarshall); } },
+        { "astar", [](const PlannerConfig&) { return std::make_shared<BlockedNodePlanner>(&astar); } },
+        { "exit-tree", [](const PlannerConfig&) { return std::make_shared<ExitTreePlanner>(); } },
+    };
+    return registry;
+}
+
+// 탐색기를 name으로 등록하는 함수 (같은 이름이 있으면 바꾼다, 시뮬레이션을 만들기 전에 등록한다)
+inline void registerPlanner(const std::string& name, PlannerFactory factory) {
+    for (auto& entry : plannerRegistry()) {
+        if (entry.first == name) {
+            entry.second = factory;
+            return;
+        }
+    }
+    plannerRegistry().emplace_back(name, factory);
+}
+
+inline bool hasPlanner(const std::string& name) {
+    for (const auto& entry : plannerRegistry()) {
+        if (entry.first == name) return true;
+    }
+    return false;
+}
+
+// name으로 등록된 탐색기를 만드는 함수 (등록되지 않은 이름이면 nullptr)
+inline std::shared_ptr<Planner> makePlanner(const std::string& name, const PlannerConfig& config) {
+    for (const auto& entry : plannerRegistry()) {
+        if (entry.first == name) return entry.second(config);
+    }
+    return nullptr;
+}
+
+// 등록된 탐색기 이름을 쉼표로 이은 문자열 (도움말과 오류 메시지용)
+inline std::string plannerNames() {
+    std::string names;
+    for (const auto& entry : plannerRegistry()) {
+        if (!names.empty()) names += ", ";
+        names += entry.first;
+    }
+    return names;
+}
+
+// 예전 시나리오 파일의 알고리즘 번호(1: 다익스트라, 2: 벨만-포드, 3: 플로이드 워셜, 4: A*, 5: 화재 도달 시각을 고려한 탐색)에 해당하는 탐색기 이름 (없는 번호면 빈 문자열)
+inline std::string legacyPlannerName(int algorithm) {
+    const char* names[] = { "dijkstra", "bellman-ford", "floyd-warshall", "astar", "time-aware" };
+    return algorithm >= 1 && algorithm <= 5 ? names[algorithm - 1] : "";
+}
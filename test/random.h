@@ -0,0 +1,63 @@
+#pragma once
+
+#include <cstdint>
+
+// 시드로 재현할 수 있는 xoshiro256** 난수 생성기
+// (시드, 스트림 번호)마다 서로 독립된 난수열을 만들므로, 작업마다 자기 스트림을 쓰면 스레드 수나 실행 순서와 관계없이 결과가 같다.
+// 표준 분포 클래스는 표준 라이브러리 구현마다 결과가 달라 쓰지 않고, 필요한 분포는 정수 연산만으로 직접 만든다 (어느 플랫폼에서든 같은 결과).
+class Random {
+public:
+    explicit Random(std::uint64_t seed, std::uint64_t stream = 0) {
+        // 스트림 번호를 섞은 시드에서 splitmix64로 상태를 채운다
+        std::uint64_t x = seed ^ mix(stream + 0x632BE59BD9B4E019ULL);
+        for (int i = 0; i < 4; ++i) {
+            x += 0x9E3779B97F4A7C15ULL;
+            state[i] = mix(x);
+        }
+    }
+
+    // 64비트 난수
+    std::uint64_t next() {
+        std::uint64_t result = rotl(state[1] * 5, 7) * 9;
+        std::uint64_t t = state[1] << 17;
+        state[2] ^= state[0];
+        state[3] ^= state[1];
+        state[1] ^= state[2];
+        state[0] ^= state[3];
+        state[2] ^= t;
+        state[3] = rotl(state[3], 45);
+        return result;
+    }
+
+    // [0, n) 범위의 정수 (n > 0, 곱셈 후 치우치는 구간만 다시 뽑는 Lemire 방식)
+    int below(int n) {
+        std::uint32_t range = static_cast<std::uint32_t>(n);
+        std::uint64_t m = (next() >> 32) * range;
+        if (static_cast<std::uint32_t>(m) < range) {
+            std::uint32_t threshold = (0u - range) % range;
+            while (static_cast<std::uint32_t>(m) < threshold) {
+                m = (next() >> 32) * range;
+            }
+        }
+        return static_cast<int>(m >> 32);
+    }
+
+    // [0, 1) 범위의 실수 (상위 53비트)
+    double uniform() {
+        return static_cast<double>(next() >> 11) * (1.0 / 9007199254740992.0);
+    }
+
+private:
+    static std::uint64_t rotl(std::uint64_t x, int k) {
+        return (x << k) | (x >> (64 - k));
+    }
+
+    // splitmix64의 섞는 함수
+    static std::uint64_t mix(std::uint64_t z) {
+        z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+        z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+        return z ^ (z >> 31);
+    }
+
+    std::uint64_t state[4];
+};
@@ -0,0 +1,631 @@
+#pragma once
+
+#include <vector>
+#include <string>
+#include <fstream>
+#include <iterator>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <cstdint>
+#include <cstring>
+#include <cmath>
+#include <algorithm>
+
+#include "graph.h"
+#include "node_bitset.h"
+#include "event_simulation.h"
+#include "crowd.h"
+#include "simulation.h"
+
+// 리플레이 파일 형식
+// 헤더: "FRPL" + 버전(varint) + 노드 수(varint), 그 뒤로 프레임이 이어진다.
+// 프레임: 길이(varint) + 종류(1바이트) + 내용. 길이만 읽고 건너뛸 수 있으므로 파일을 열 때 키프레임 위치만 빠르게 모은다.
+//   키프레임: 시각(마이크로초, varint) + 화재/플레이어/군중의 전체 상태
+//   변화 프레임: 직전 프레임과의 시각 차(마이크로초, varint) + 한 step 동안의 사건 기록들
+// 정수는 모두 LEB128 varint로, 노드/에이전트 번호는 직전 값과의 차를 zigzag로 부호화해 작게 만든다.
+namespace replay {
+
+const char MAGIC[4] = { 'F', 'R', 'P', 'L' };
+const std::uint64_t VERSION = 1;
+
+enum FrameKind : std::uint8_t {
+    DeltaFrame = 0,
+    Keyframe = 1
+};
+
+// 변화 프레임 안의 사건 기록 종류 (AgentRun + CrowdEvent 값은 같은 종류의 에이전트 사건이 연달아 나온 묶음)
+enum RecordKind : std::uint8_t {
+    Ignite = 0,  // 새로 불붙은 노드들
+    Route = 1,  // 플레이어의 새 경로
+    PlayerAdvance = 2,  // 플레이어가 경로의 다음 노드에 도착
+    PlayerFinish = 3,  // 플레이어가 탈출했거나 갇힘
+    AgentRun = 8
+};
+
+inline void putVarint(std::vector<std::uint8_t>& out, std::uint64_t value) {
+    while (value >= 0x80) {
+        out.push_back(static_cast<std::uint8_t>(value | 0x80));
+        value >>= 7;
+    }
+    out.push_back(static_cast<std::uint8_t>(value));
+}
+
+inline void putSigned(std::vector<std::uint8_t>& out, std::int64_t value) {
+    putVarint(out, (static_cast<std::uint64_t>(value) << 1) ^ static_cast<std::uint64_t>(value >> 63));
+}
+
+template <typename T>
+void putRaw(std::vector<std::uint8_t>& out, T value) {
+    std::uint8_t bytes[sizeof(T)];
+    std::memcpy(bytes, &value, sizeof(T));
+    out.insert(out.end(), bytes, bytes + sizeof(T));
+}
+
+// 버퍼를 앞에서부터 읽는 커서 (끝을 넘겨 읽으면 ok가 false가 되고 0을 반환한다)
+struct Cursor {
+    const std::uint8_t* at;
+    const std::uint8_t* end;
+    bool ok;
+
+    Cursor(const std::uint8_t* begin, const std::uint8_t* end) : at(begin), end(end), ok(true) {}
+
+    bool more() const { return ok && at < end; }
+
+    std::uint8_t byte() {
+        if (at >= end) {
+            ok = false;
+            return 0;
+        }
+        return *at++;
+    }
+
+    std::uint64_t varint() {
+        std::uint64_t value = 0;
+        for (int shift = 0; shift < 64; shift += 7) {
+            std::uint8_t b = byte();
+            value |= static_cast<std::uint64_t>(b & 0x7F) << shift;
+            if (!(b & 0x80)) return value;
+        }
+        ok = false;
+        return 0;
+    }
+
+    std::int64_t signedVarint() {
+        std::uint64_t value = varint();
+        return static_cast<std::int64_t>(value >> 1) ^ -static_cast<std::int64_t>(value & 1);
+    }
+
+    template <typename T>
+    T raw() {
+        T value = T();
+        if (end - at < static_cast<std::ptrdiff_t>(sizeof(T))) {
+            ok = false;
+            return value;
+        }
+        std::memcpy(&value, at, sizeof(T));
+        at += sizeof(T);
+        return value;
+    }
+};
+
+inline std::uint64_t toMicros(double seconds) {
+    return static_cast<std::uint64_t>(std::llround(seconds * 1e6));
+}
+
+} // namespace replay
+
+// 리플레이 기록 설정
+struct ReplayConfig {
+    double keyframeInterval = 10.0;  // 키프레임 간격 (시뮬레이션 초, 탐색할 때 이 간격 안의 변화 프레임만 다시 적용한다)
+    size_t bufferBytes = 1 << 20;  // 시뮬레이션 스레드와 파일 쓰기 스레드 사이의 링 버퍼 크기
+};
+
+// 시뮬레이션의 사건(발화, 경로 변경, 플레이어/군중의 간선 이동)을 리플레이 파일로 기록하는 관찰자
+// 시뮬레이션 스레드는 step마다 사건을 부호화해 링 버퍼에 넣기만 하고, 파일 쓰기는 전용 스레드가 한다 (버퍼가 가득 차면 빌 때까지 기다린다).
+// 시뮬레이션에 등록한 콜백이 기록기를 가리키므로 기록기가 소멸한 뒤에는 시뮬레이션을 진행하면 안 된다 (시뮬레이션보다 나중에 만들어 먼저 소멸시킨다).
+// close 또는 소멸할 때 마지막 키프레임을 쓰고 남은 내용을 모두 파일에 쓴다.
+class ReplayRecorder {
+public:
+    explicit ReplayRecorder(const std::string& filename, const ReplayConfig& config = ReplayConfig())
+        : file(filename, std::ios::binary), config(config), ring(std::max<size_t>(config.bufferBytes, 64)),
+          readPosition(0), writePosition(0), closing(false), simulation(nullptr),
+          frameTime(0), nextKeyframe(0.0), frameCount(0), keyframeCount(0), byteCount(0) {
+        if (file) writer = std::thread([this]() { writerLoop(); });
+    }
+
+    ~ReplayRecorder() { close(); }
+
+    ReplayRecorder(const ReplayRecorder&) = delete;
+    ReplayRecorder& operator=(const ReplayRecorder&) = delete;
+
+    bool good() const { return static_cast<bool>(file); }
+
+    // 시뮬레이션에 관찰자로 등록하고 헤더와 첫 키프레임을 쓰는 함수 (군중을 모두 추가한 뒤, 첫 step 전에 호출한다)
+    void attach(Simulation& simulation) {
+        this->simulation = &simulation;
+        simulation.crowd().recordTransitions(true);
+
+        frame.assign(replay::MAGIC, replay::MAGIC + 4);
+        replay::putVarint(frame, replay::VERSION);
+        replay::putVarint(frame, static_cast<std::uint64_t>(simulation.fireNodes().size()));
+        push(frame);
+        writeKeyframe();
+
+        SimulationObserver observer;
+        observer.onIgnite = [this](const std::vector<int>& ignited) {
+            pending.push_back(replay::Ignite);
+            replay::putVarint(pending, ignited.size());
+            putNodes(pending, ignited);
+        };
+        observer.onPathChanged = [this](const std::vector<int>& path) {
+            pending.push_back(replay::Route);
+            replay::putVarint(pending, path.size());
+            putNodes(pending, path);
+        };
+        observer.onPlayerAdvance = [this](size_t position) {
+            pending.push_back(replay::PlayerAdvance);
+            replay::putVarint(pending, position);
+        };
+        observer.onPlayerFinished = [this](AgentStatus status) {
+            pending.push_back(replay::PlayerFinish);
+            pending.push_back(static_cast<std::uint8_t>(status));
+        };
+        observer.onStepEnd = [this]() { endStep(); };
+        simulation.addObserver(observer);
+    }
+
+    // 마지막 키프레임을 쓰고 파일 쓰기 스레드가 남은 내용을 모두 쓸 때까지 기다리는 함수 (이후의 사건은 기록하지 않는다)
+    void close() {
+        if (simulation) {
+            writeKeyframe();
+            simulation->crowd().recordTransitions(false);
+            simulation = nullptr;
+        }
+        if (writer.joinable()) {
+            {
+                std::lock_guard<std::mutex> lock(mutex);
+                closing = true;
+            }
+            dataReady.notify_one();
+            writer.join();
+            file.flush();
+        }
+    }
+
+    long long frames() const { return frameCount; }  // 쓴 프레임 수 (키프레임 포함)
+    long long keyframes() const { return keyframeCount; }
+    long long bytes() const { return byteCount; }  // 파일 크기 (헤더 포함)
+
+private:
+    // 오름차순이 아닐 수 있는 노드 목록을 직전 노드와의 차로 부호화
+    static void putNodes(std::vector<std::uint8_t>& out, const std::vector<int>& nodes) {
+        int previous = 0;
+        for (int id : nodes) {
+            replay::putSigned(out, id - previous);
+            previous = id;
+        }
+    }
+
+    // 간선 속도 비율(0 ~ 1)을 1바이트로 (재생할 때 다음 사건까지의 진행률을 보간하는 데만 쓴다)
+    static std::uint8_t speedByte(float speed) {
+        return static_cast<std::uint8_t>(std::lround(std::min(std::max(speed, 0.0f), 1.0f) * 255.0f));
+    }
+
+    // step 하나의 사건을 변화 프레임으로 쓰는 함수 (키프레임 시각이 되었으면 대신 키프레임을 쓴다)
+    void endStep() {
+        if (!simulation) return;
+        const Crowd& crowd = simulation->crowd();
+        std::vector<CrowdTransition>& transitions = simulation->crowd().transitions();
+        if (simulation->time() >= nextKeyframe) {
+            pending.clear();
+            transitions.clear();
+            writeKeyframe();
+            return;
+        }
+
+        // 군중 사건은 순서를 지키며 같은 종류가 연달아 나온 묶음으로 쓴다 (한 에이전트가 한 step에 여러 사건을 겪을 수 있다)
+        for (size_t begin = 0; begin < transitions.size();) {
+            CrowdEvent event = transitions[begin].event;
+            size_t end = begin;
+            while (end < transitions.size() && transitions[end].event == event) end++;
+            pending.push_back(static_cast<std::uint8_t>(replay::AgentRun + static_cast<int>(event)));
+            replay::putVarint(pending, end - begin);
+            int previous = 0;
+            for (size_t i = begin; i < end; ++i) {
+                replay::putSigned(pending, transitions[i].agent - previous);
+                previous = transitions[i].agent;
+                if (event == CrowdEvent::Enter) {
+                    replay::putVarint(pending, static_cast<std::uint64_t>(transitions[i].node));
+                    pending.push_back(speedByte(crowd.speed(transitions[i].agent)));
+                }
+            }
+            begin = end;
+        }
+        transitions.clear();
+        if (pending.empty()) return;
+
+        std::uint64_t now = replay::toMicros(simulation->time());
+        frame.clear();
+        frame.push_back(replay::DeltaFrame);
+        replay::putVarint(frame, now - frameTime);
+        frame.insert(frame.end(), pending.begin(), pending.end());
+        pending.clear();
+        frameTime = now;
+        pushFrame();
+    }
+
+    // 현재 시각의 전체 상태를 키프레임으로 쓰는 함수
+    void writeKeyframe() {
+        const Simulation& sim = *simulation;
+        std::uint64_t now = replay::toMicros(sim.time());
+        frame.clear();
+        frame.push_back(replay::Keyframe);
+        replay::putVarint(frame, now);
+
+        std::vector<int> burning;
+        sim.fireNodes().forEach([&](int id) { burning.push_back(id); });
+        replay::putVarint(frame, burning.size());
+        putNodes(frame, burning);
+
+        frame.push_back(static_cast<std::uint8_t>(sim.status()));
+        replay::putVarint(frame, sim.playerPath().size());
+        putNodes(frame, sim.playerPath());
+        replay::putVarint(frame, sim.pathPosition());
+        replay::putRaw(frame, sim.progress());
+
+        const Crowd& crowd = sim.crowd();
+        replay::putVarint(frame, static_cast<std::uint64_t>(crowd.size()));
+        for (int i = 0; i < crowd.size(); ++i) {
+            frame.push_back(static_cast<std::uint8_t>(crowd.status(i)));
+            replay::putVarint(frame, static_cast<std::uint64_t>(crowd.source(i)));
+            replay::putVarint(frame, static_cast<std::uint64_t>(crowd.target(i) + 1));
+            replay::putRaw(frame, crowd.progress(i));
+            frame.push_back(speedByte(crowd.speed(i)));
+        }
+
+        frameTime = now;
+        nextKeyframe = sim.time() + config.keyframeInterval;
+        keyframeCount++;
+        pushFrame();
+    }
+
+    // 프레임 길이를 앞에 붙여 링 버퍼에 넣는 함수
+    void pushFrame() {
+        header.clear();
+        replay::putVarint(header, frame.size());
+        push(header);
+        push(frame);
+        frameCount++;
+    }
+
+    // 바이트를 링 버퍼에 복사하는 함수 (빈 자리가 없으면 파일 쓰기 스레드가 비울 때까지 기다린다)
+    void push(const std::vector<std::uint8_t>& bytes) {
+        byteCount += static_cast<long long>(bytes.size());
+        if (!writer.joinable()) return;
+        size_t capacity = ring.size();
+        for (size_t done = 0; done < bytes.size();) {
+            size_t space;
+            {
+                std::unique_lock<std::mutex> lock(mutex);
+                spaceReady.wait(lock, [&]() { return writePosition - readPosition < capacity; });
+                space = capacity - (writePosition - readPosition);
+            }
+            // 쓰기 위치부터 버퍼 끝까지와 빈 자리 중 작은 만큼 복사 (이 구간은 파일 쓰기 스레드가 읽지 않는다)
+            size_t offset = writePosition % capacity;
+            size_t count = std::min(std::min(space, capacity - offset), bytes.size() - done);
+            std::memcpy(&ring[offset], &bytes[done], count);
+            done += count;
+            {
+                std::lock_guard<std::mutex> lock(mutex);
+                writePosition += count;
+            }
+            dataReady.notify_one();
+        }
+    }
+
+    // 파일 쓰기 스레드: 링 버퍼에 쌓인 바이트를 이어진 구간 단위로 파일에 쓴다
+    void writerLoop() {
+        size_t capacity = ring.size();
+        while (true) {
+            size_t begin, available;
+            {
+                std::unique_lock<std::mutex> lock(mutex);
+                dataReady.wait(lock, [this]() { return closing || writePosition != readPosition; });
+                if (writePosition == readPosition) return; // closing이고 남은 내용이 없음
+                begin = readPosition;
+                available = writePosition - readPosition;
+            }
+            size_t offset = begin % capacity;
+            size_t count = std::min(available, capacity - offset);
+            file.write(reinterpret_cast<const char*>(&ring[offset]), static_cast<std::streamsize>(count));
+            {
+                std::lock_guard<std::mutex> lock(mutex);
+                readPosition += count;
+            }
+            spaceReady.notify_one();
+        }
+    }
+
+    std::ofstream file;
+    ReplayConfig config;
+
+    // 단일 생산자/단일 소비자 링 버퍼 (위치는 계속 늘어나는 값이고, 버퍼 안의 위치는 capacity로 나눈 나머지)
+    std::vector<std::uint8_t> ring;
+    size_t readPosition;
+    size_t writePosition;
+    bool closing;
+    std::mutex mutex;
+    std::condition_variable dataReady;
+    std::condition_variable spaceReady;
+    std::thread writer;
+
+    Simulation* simulation;
+    std::vector<std::uint8_t> pending;  // 이번 step에 모은 사건 기록
+    std::vector<std::uint8_t> frame;
+    std::vector<std::uint8_t> header;
+    std::uint64_t frameTime;  // 마지막 프레임의 시각 (마이크로초)
+    double nextKeyframe;  // 다음 키프레임을 쓸 시뮬레이션 시각
+    long long frameCount;
+    long long keyframeCount;
+    long long byteCount;
+};
+
+// 리플레이의 한 시각 상태
+struct ReplayState {
+    double time = 0.0;
+    NodeBitset fireNodes;  // 불타는 노드
+    AgentStatus playerStatus = AgentStatus::Moving;
+    std::vector<int> playerPath;
+    size_t pathPosition = 0;  // 마지막으로 출발한 경로 노드의 위치
+    double playerProgress = 0.0;  // 현재 간선의 진행률
+    std::vector<CrowdStatus> agentStatuses;
+    std::vector<int> agentSources;  // 현재 간선의 출발 노드 (노드 위에 있으면 그 노드)
+    std::vector<int> agentTargets;  // 현재 간선의 도착 노드 (다음 간선을 기다리는 중이면 -1)
+    std::vector<float> agentProgresses;
+};
+
+// 리플레이 파일을 읽고 임의의 시각으로 바로 이동하는 재생기
+// 파일을 열 때 키프레임 위치만 모아 두고, seek(t)는 t 이전의 마지막 키프레임에서 시작해 t까지의 변화 프레임만 적용한다.
+// 변화 프레임에는 간선에 들어선 시각과 그때의 속도만 있으므로, 사건 사이의 군중 진행률은 그 속도가 유지된다고 본 근사값이다 (노드 도착 같은 사건은 정확하다).
+class ReplayReader {
+public:
+    // travelTimes는 기록할 때와 같은 간선별 이동 시간 (진행률 보간용)
+    ReplayReader(const Graph& graph, const std::vector<double>& travelTimes) : graph(&graph), travelTimes(travelTimes) {}
+
+    // 파일을 읽어 키프레임 위치를 모으는 함수 (형식이 잘못되었으면 error에 이유를 채우고 false를 반환한다)
+    bool open(const std::string& filename, std::string& error) {
+        std::ifstream file(filename, std::ios::binary);
+        if (!file) {
+            error = "Could not read " + filename;
+            return false;
+        }
+        data.assign(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+        keyframes.clear();
+        frameCount = 0;
+
+        replay::Cursor cursor(data.data(), data.data() + data.size());
+        if (data.size() < 4 || std::memcmp(data.data(), replay::MAGIC, 4) != 0) {
+            error = filename + " is not a replay file";
+            return false;
+        }
+        cursor.at += 4;
+        std::uint64_t version = cursor.varint();
+        std::uint64_t nodeCount = cursor.varint();
+        if (!cursor.ok || version != replay::VERSION || nodeCount != static_cast<std::uint64_t>(graph->size())) {
+            error = filename + " was recorded with a different version or map";
+            return false;
+        }
+
+        std::uint64_t time = 0;
+        while (cursor.more()) {
+            size_t offset = static_cast<size_t>(cursor.at - data.data());
+            std::uint64_t length = cursor.varint();
+            if (!cursor.ok || length == 0 || length > static_cast<std::uint64_t>(cursor.end - cursor.at)) break; // 기록이 중간에 끊긴 파일은 온전한 프레임까지만 쓴다
+            replay::Cursor frame(cursor.at, cursor.at + length);
+            std::uint8_t kind = frame.byte();
+            if (kind == replay::Keyframe) {
+                time = frame.varint();
+                keyframes.push_back({ time, offset });
+            }
+            else {
+                time += frame.varint();
+            }
+            cursor.at += length;
+            frameCount++;
+        }
+        endTime = time;
+        if (keyframes.empty()) {
+            error = filename + " has no keyframe";
+            return false;
+        }
+        return true;
+    }
+
+    double duration() const { return endTime * 1e-6; }
+    size_t frames() const { return frameCount; }
+    size_t keyframeCount() const { return keyframes.size(); }
+
+    // time초의 상태를 state에 채우는 함수 (기록 범위를 벗어나면 처음/끝 상태)
+    void seek(double time, ReplayState& state) const {
+        std::uint64_t target = replay::toMicros(std::max(0.0, time));
+        size_t k = 0;
+        while (k + 1 < keyframes.size() && keyframes[k + 1].time <= target) k++;
+
+        Decoder decoder(*graph, state);
+        replay::Cursor cursor(data.data() + keyframes[k].offset, data.data() + data.size());
+        std::uint64_t now = 0;
+        for (bool first = true; cursor.more(); first = false) {
+            const std::uint8_t* frameStart = cursor.at;
+            std::uint64_t length = cursor.varint();
+            if (!cursor.ok || length == 0 || length > static_cast<std::uint64_t>(cursor.end - cursor.at)) break;
+            replay::Cursor frame(cursor.at, cursor.at + length);
+            std::uint8_t kind = frame.byte();
+            std::uint64_t frameTime = kind == replay::Keyframe ? frame.varint() : now + frame.varint();
+            if (!first && (frameTime > target || kind == replay::Keyframe)) {
+                cursor.at = frameStart;
+                break;
+            }
+            now = frameTime;
+            if (kind == replay::Keyframe) decoder.keyframe(frame, now);
+            else decoder.delta(frame, now);
+            cursor.at += length;
+        }
+
+        // 마지막 사건 이후 흐른 시간만큼 진행률을 보간한다 (다음 사건 전에 간선 끝에 닿지 않도록 1 미만으로 자른다)
+        const double maxProgress = 0.999;
+        std::uint64_t reached = std::max(now, std::min(target, endTime));
+        state.time = reached * 1e-6;
+        if (state.playerStatus == AgentStatus::Moving && state.pathPosition + 1 < state.playerPath.size()) {
+            int e = graph->edge(state.playerPath[state.pathPosition], state.playerPath[state.pathPosition + 1]);
+            double elapsed = (reached - decoder.playerSince) * 1e-6;
+            state.playerProgress = std::min(decoder.playerBase + elapsed / travelTimes[e], maxProgress);
+        }
+        for (size_t i = 0; i < state.agentStatuses.size(); ++i) {
+            if (state.agentStatuses[i] != CrowdStatus::Moving || state.agentTargets[i] < 0) continue;
+            int e = graph->edge(state.agentSources[i], state.agentTargets[i]);
+            double elapsed = (reached - decoder.agentSince[i]) * 1e-6;
+            double speed = decoder.agentSpeed[i] / 255.0;
+            state.agentProgresses[i] = static_cast<float>(std::min(decoder.agentBase[i] + elapsed * speed / travelTimes[e], maxProgress));
+        }
+    }
+
+private:
+    struct KeyframeEntry {
+        std::uint64_t time;  // 마이크로초
+        size_t offset;  // 프레임(길이 varint)의 위치
+    };
+
+    // 프레임을 상태에 적용하는 도우미 (진행률은 기준 시각의 값과 그 시각을 따로 들고 있다가 seek 끝에 보간한다)
+    struct Decoder {
+        const Graph& graph;
+        ReplayState& state;
+        double playerBase = 0.0;
+        std::uint64_t playerSince = 0;
+        std::vector<double> agentBase;
+        std::vector<std::uint8_t> agentSpeed;  // 간선에 들어섰을 때(또는 키프레임에서)의 속도 비율 x 255
+        std::vector<std::uint64_t> agentSince;
+
+        Decoder(const Graph& graph, ReplayState& state) : graph(graph), state(state) {}
+
+        static void readNodes(replay::Cursor& frame, std::vector<int>& nodes, std::uint64_t count) {
+            nodes.clear();
+            int previous = 0;
+            for (std::uint64_t i = 0; i < count && frame.ok; ++i) {
+                previous += static_cast<int>(frame.signedVarint());
+                nodes.push_back(previous);
+            }
+        }
+
+        void keyframe(replay::Cursor& frame, std::uint64_t now) {
+            std::vector<int> nodes;
+            state.fireNodes = NodeBitset(graph.size());
+            readNodes(frame, nodes, frame.varint());
+            for (int id : nodes) {
+                if (id >= 0 && id < graph.size()) state.fireNodes.set(id);
+            }
+
+            state.playerStatus = static_cast<AgentStatus>(frame.byte());
+            readNodes(frame, state.playerPath, frame.varint());
+            state.pathPosition = static_cast<size_t>(frame.varint());
+            state.playerProgress = frame.raw<double>();
+            playerBase = state.playerProgress;
+            playerSince = now;
+
+            size_t count = static_cast<size_t>(frame.varint());
+            state.agentStatuses.resize(count);
+            state.agentSources.resize(count);
+            state.agentTargets.resize(count);
+            state.agentProgresses.resize(count);
+            agentBase.resize(count);
+            agentSpeed.resize(count);
+            agentSince.assign(count, now);
+            for (size_t i = 0; i < count && frame.ok; ++i) {
+                state.agentStatuses[i] = static_cast<CrowdStatus>(frame.byte());
+                state.agentSources[i] = static_cast<int>(frame.varint());
+                state.agentTargets[i] = static_cast<int>(frame.varint()) - 1;
+                state.agentProgresses[i] = frame.raw<float>();
+                agentBase[i] = state.agentProgresses[i];
+                agentSpeed[i] = frame.byte();
+            }
+        }
+
+        void delta(replay::Cursor& frame, std::uint64_t now) {
+            std::vector<int> nodes;
+            while (frame.more()) {
+                std::uint8_t kind = frame.byte();
+                if (kind == replay::Ignite) {
+                    readNodes(frame, nodes, frame.varint());
+                    for (int id : nodes) {
+                        if (id >= 0 && id < graph.size()) state.fireNodes.set(id);
+                    }
+                }
+                else if (kind == replay::Route) {
+                    readNodes(frame, state.playerPath, frame.varint());
+                    state.pathPosition = 0;
+                    playerBase = 0.0;
+                    playerSince = now;
+                }
+                else if (kind == replay::PlayerAdvance) {
+                    state.pathPosition = static_cast<size_t>(frame.varint());
+                    playerBase = 0.0;
+                    playerSince = now;
+                }
+                else if (kind == replay::PlayerFinish) {
+                    state.playerStatus = static_cast<AgentStatus>(frame.byte());
+                }
+                else if (kind >= replay::AgentRun && kind <= replay::AgentRun + static_cast<int>(CrowdEvent::Reroute)) {
+                    CrowdEvent event = static_cast<CrowdEvent>(kind - replay::AgentRun);
+                    std::uint64_t count = frame.varint();
+                    int agent = 0;
+                    for (std::uint64_t j = 0; j < count && frame.ok; ++j) {
+                        agent += static_cast<int>(frame.signedVarint());
+                        int node = -1;
+                        std::uint8_t speed = 0;
+                        if (event == CrowdEvent::Enter) {
+                            node = static_cast<int>(frame.varint());
+                            speed = frame.byte();
+                        }
+                        if (agent < 0 || agent >= static_cast<int>(state.agentStatuses.size())) continue;
+                        applyAgent(agent, event, node, speed, now);
+                    }
+                }
+                else {
+                    return; // 알 수 없는 기록 (이 프레임의 나머지는 건너뛴다)
+                }
+            }
+        }
+
+        void applyAgent(int i, CrowdEvent event, int node, std::uint8_t speed, std::uint64_t now) {
+            switch (event) {
+            case CrowdEvent::Enter:
+                state.agentTargets[i] = node;
+                agentSpeed[i] = speed;
+                agentBase[i] = 0.0;
+                agentSince[i] = now;
+                break;
+            case CrowdEvent::Arrive:
+                state.agentSources[i] = state.agentTargets[i];
+                state.agentTargets[i] = -1;
+                break;
+            case CrowdEvent::Escape:
+                state.agentStatuses[i] = CrowdStatus::Escaped;
+                break;
+            case CrowdEvent::Trap:
+                state.agentStatuses[i] = CrowdStatus::Trapped;
+                break;
+            case CrowdEvent::Reroute:
+                state.agentTargets[i] = -1;
+                break;
+            }
+            state.agentProgresses[i] = 0.0f;
+        }
+    };
+
+    const Graph* graph;
+    std::vector<double> travelTimes;
+    std::vector<std::uint8_t> data;  // 파일 전체
+    std::vector<KeyframeEntry> keyframes;
+    size_t frameCount = 0;
+    std::uint64_t endTime = 0;  // 마지막 프레임의 시각 (마이크로초)
+};
@@ -0,0 +1,423 @@
+#pragma once
+
+#include <vector>
+#include <functional>
+#include <limits>
+#include <string>
+#include <algorithm>
+
+#include "graph.h"
+#include "node_bitset.h"
+#include "pathfinding.h"
+#include "dynamic_sssp.h"
+#include "k_shortest_paths.h"
+#include "fire.h"
+#include "time_aware_route.h"
+#include "event_simulation.h"
+#include "path_index.h"
+#include "hazard.h"
+#include "crowd.h"
+#include "thread_pool.h"
+#include "random.h"
+#include "copy_on_write.h"
+#include "planner.h"
+
+// 게임 한 판의 설정
+struct SimulationConfig {
+    int playerId = 0;  // 플레이어 출발 노드
+    std::vector<int> exits;  // 탈출구 (플레이어는 이동 시간이 가장 짧은 경로가 있는 탈출구로 간다)
+    std::vector<int> ignitions;  // 최초 발화 노드
+    std::string planner = "time-aware";  // 처음 경로와 다시 찾는 경로를 모두 맡는 탐색기 이름 (planner.h, 등록되지 않은 이름이면 처음 경로가 없는 것으로 끝난다)
+    double fireTick = 3.0;  // 화재 확산 주기 (초)
+    double congestionInterval = 1.0;  // 군중 혼잡을 경로 비용에 반영하는 주기 (초)
+    int fallbackRouteCount = 3;  // 갈림길 노드마다 미리 계산할 대체 경로 수 (PlannerConfig)
+    bool precomputeFallbacks = true;  // 대체 경로를 스레드 풀에서 미리 계산 (PlannerConfig)
+    int threads = 0;  // 군중 갱신 스레드 수 (0이면 하드웨어 스레드 수)
+    SmokeConfig smoke;  // 연기 설정 (갱신 주기는 fireTick을 따른다)
+    CongestionConfig congestion;  // 군중 혼잡 설정
+};
+
+// 시뮬레이션에서 일어난 일을 받아 보는 콜백 (게임 화면, 리플레이 기록 같은 관찰자가 필요한 것만 채운다, 비어 있으면 호출하지 않는다)
+struct SimulationObserver {
+    std::function<void(const std::vector<int>& ignited)> onIgnite;  // 화재 틱에 새로 불붙은 노드
+    std::function<void(int source, int target, double duration)> onFireSpread;  // 불타던 source에서 새로 불붙은 target으로 불이 번짐 (간선을 건너는 시간)
+    std::function<void(const std::vector<int>& path)> onPathChanged;  // 플레이어의 경로가 바뀜
+    std::function<void(size_t position)> onPlayerAdvance;  // 플레이어가 경로의 position번째 노드에 도착
+    std::function<void(AgentStatus status)> onPlayerFinished;  // 플레이어가 탈출했거나 모든 경로가 막힘
+    std::function<void()> onStepEnd;  // step 한 번이 끝남 (군중 이동까지 반영된 상태)
+};
+
+// 창 없이 돌아가는 게임 한 판 (화재 확산, 플레이어 이동과 경로 재계산, 군중 대피)
+// 게임 화면은 step(프레임 간격)으로 시간을 넘겨주고, 헤드리스 실행은 runUntilDone으로 다음 사건 시각까지 바로 건너뛴다.
+// SFML에 의존하지 않으며, 게임 화면은 SimulationObserver로 사건을 받아 그리기만 한다.
+// 큰 상태(화재, 탈출구 트리, 군중, 경로 탐색기)는 copy-on-write로 들고 있어, 스냅샷을 만들거나 되돌리는 비용이 상태 크기와 관계없이 작다.
+class Simulation {
+    // 화재 틱마다 바뀌는 상태
+    struct FireState {
+        NodeBitset burningNodes;  // 불타는 노드
+        FireField fireField;  // 발화 지점에서 각 노드까지 불이 도달하는 시각 (현재는 틱마다 인접 노드로 한 칸씩 번진다)
+        SmokeField smoke;
+
+        FireState(const Graph& graph, const SimulationConfig& config)
+            : burningNodes(graph.size()), fireField(graph, config.ignitions, [&config](int) { return config.fireTick; }),
+              smoke(graph, smokeConfig(config)) {}
+    };
+
+public:
+    // 시뮬레이션 한 시점의 전체 상태 (snapshot으로 만들고 restore로 되돌린다)
+    // 큰 상태는 시뮬레이션과 나눠 가지며, 스냅샷에서 갈라진 시뮬레이션은 처음 고치는 부분만 복사한다.
+    // 스냅샷은 바뀌지 않으므로 여러 스레드의 시뮬레이션이 같은 스냅샷에서 동시에 갈라져도 된다.
+    class Snapshot {
+    public:
+        double time() const { return now; }
+
+    private:
+        friend class Simulation;
+
+        explicit Snapshot(const Simulation& simulation)
+            : fire(simulation.fire), exitTrees(simulation.exitTrees), agents(simulation.agents), planner(simulation.planner),
+              path(simulation.path), currentPathIndex(simulation.currentPathIndex),
+              interpolation(simulation.interpolation), weightSum(simulation.weightSum), passedNodes(simulation.passedNodes),
+              pathIndex(simulation.pathIndex), burningAhead(simulation.burningAhead), playerStatus(simulation.playerStatus),
+              now(simulation.now), sinceFire(simulation.sinceFire), fireTime(simulation.fireTime),
+              nextReweight(simulation.nextReweight), escapedAt(simulation.escapedAt) {}
+
+        CopyOnWrite<FireState> fire;
+        CopyOnWrite<std::vector<ExitTree>> exitTrees;
+        CopyOnWrite<Crowd> agents;
+        CopyOnWrite<Planner, ClonePlanner> planner;
+        std::vector<int> path;
+        size_t currentPathIndex;
+        double interpolation;
+        double weightSum;
+        NodeBitset passedNodes;
+        PathIndex pathIndex;
+        int burningAhead;
+        AgentStatus playerStatus;
+        double now;
+        double sinceFire;
+        double fireTime;
+        double nextReweight;
+        double escapedAt;
+    };
+
+    // travelTimes[e]는 간선 e를 지나는 시간, capacities[e]는 군중 혼잡 모델의 간선 용량 (초당 인원)
+    Simulation(const Graph& graph, const std::vector<double>& travelTimes, const std::vector<double>& capacities, const SimulationConfig& config)
+        : graph(&graph), travelTimes(travelTimes), config(config), fire(std::make_shared<FireState>(graph, config)),
+          exitTrees(std::make_shared<std::vector<ExitTree>>(buildExitTrees(graph, config.exits))),
+          agents(std::make_shared<Crowd>(graph, travelTimes, treePointers(*exitTrees), config.threads)),
+          planner(makePlanner(config.planner, plannerConfig(config))), fallbackBuild(sharedPool()),
+          currentPathIndex(0), interpolation(0.0), weightSum(0.0), passedNodes(graph.size()),
+          pathIndex(graph.size()), burningAhead(0), playerStatus(AgentStatus::Moving),
+          now(0.0), sinceFire(0.0), fireTime(0.0), nextReweight(config.congestionInterval), escapedAt(0.0) {
+        FireState& state = fire.edit();
+        for (int id : config.ignitions) {
+            state.burningNodes.set(id);
+        }
+        for (auto& tree : exitTrees.edit()) {
+            tree.removeNodes(config.ignitions);
+        }
+        agents.edit().enableCongestion(capacities, config.congestion);
+
+        // 탐색기가 미리 계산할 것(대체 경로 등)은 스레드 풀에서 낮은 우선순위로 돌리고, 처음 경로를 찾는다
+        if (planner) planner.edit().prepare(planContext());
+        state.fireField.ignite(0.0); // 최초 발화 노드는 이미 burningNodes에 반영됨
+        if (planner) path = planner.edit().plan(planContext(), config.playerId);
+        if (path.empty()) {
+            playerStatus = AgentStatus::NoInitialPath;
+        }
+        else if (path.size() == 1) {
+            playerStatus = AgentStatus::Escaped; // 탈출구에서 출발
+        }
+        indexPath();
+    }
+
+    Simulation(const Simulation&) = delete;
+    Simulation& operator=(const Simulation&) = delete;
+
+    void addObserver(const SimulationObserver& observer) { observers.push_back(observer); }
+
+    // 현재 상태의 스냅샷 (탐색기가 미리 계산 중인 작업이 있으면 끝날 때까지 기다린다)
+    Snapshot snapshot() {
+        fallbackBuild.wait();
+        return Snapshot(*this);
+    }
+
+    // 스냅샷의 상태로 되돌리는 함수 (같은 그래프와 설정으로 만든 다른 시뮬레이션의 스냅샷이어도 된다, 관찰자에게는 알리지 않는다)
+    void restore(const Snapshot& snapshot) {
+        fallbackBuild.wait(); // 미리 계산 작업이 지금의 탐색기에 쓰고 있을 수 있다
+        fire = snapshot.fire;
+        exitTrees = snapshot.exitTrees;
+        agents = snapshot.agents;
+        planner = snapshot.planner;
+        path = snapshot.path;
+        currentPathIndex = snapshot.currentPathIndex;
+        interpolation = snapshot.interpolation;
+        weightSum = snapshot.weightSum;
+        passedNodes = snapshot.passedNodes;
+        pathIndex = snapshot.pathIndex;
+        burningAhead = snapshot.burningAhead;
+        playerStatus = snapshot.playerStatus;
+        now = snapshot.now;
+        sinceFire = snapshot.sinceFire;
+        fireTime = snapshot.fireTime;
+        nextReweight = snapshot.nextReweight;
+        escapedAt = snapshot.escapedAt;
+    }
+
+    // 다음 화재 틱에 nodes에도 불이 붙게 하는 함수 (그 뒤로는 다른 불과 같이 번진다)
+    // 스냅샷에서 갈라진 미래마다 화재가 다르게 번지는 경우를 살펴볼 때 쓴다
+    void addIgnitions(const std::vector<int>& nodes) {
+        double tick = config.fireTick;
+        fire.edit().fireField.addIgnitions(*graph, nodes, fireTime + tick, [tick](int) { return tick; });
+    }
+
+    // 불타지 않는 임의의 노드에 군중 에이전트를 count명 추가하는 함수 (모든 노드가 불타면 불타는 노드에도 둔다)
+    void spawnAgents(int count, Random& random) {
+        const NodeBitset& burningNodes = fire->burningNodes;
+        Crowd& crowd = crowdForUpdate();
+        int n = graph->size();
+        int burning = 0;
+        for (int id = 0; id < n; ++id) {
+            if (burningNodes.test(id)) burning++;
+        }
+        for (int i = 0; i < count; ++i) {
+            int node = random.below(n);
+            while (burningNodes.test(node) && burning < n) node = random.below(n);
+            crowd.add(node);
+        }
+    }
+
+    // dt초만큼 진행하는 함수: 화재 확산(주기마다) -> 플레이어 이동 -> 군중 이동 순
+    // 플레이어가 탈출하거나 갇힌 뒤에도 화재와 군중은 계속 진행된다
+    // (화재 틱, 간선 도착, 혼잡 반영 시각은 EPS 안에서 맞으면 지난 것으로 본다: runUntilDone이 사건 시각에 딱 맞춰 진행해도 반올림으로 놓치지 않도록)
+    void step(double dt) {
+        const double EPS = 1e-9;
+        now += dt;
+        sinceFire += dt;
+        if (sinceFire > config.fireTick - EPS) {
+            sinceFire = 0.0; // 게임 화면과 같이 틱이 늦게 온 만큼은 다음 틱으로 넘기지 않는다
+            spreadFire();
+        }
+
+        if (playerStatus == AgentStatus::Moving) {
+            movePlayer(dt);
+        }
+
+        // 군중 에이전트 이동 (주기적으로 간선 혼잡을 탈출구 트리의 비용에 반영)
+        Crowd& crowd = crowdForUpdate();
+        crowd.update(dt);
+        if (crowd.time() >= nextReweight - EPS) {
+            crowd.reweight(fire->smoke.costs(), costChanges);
+            updateTreeCosts();
+            nextReweight += config.congestionInterval;
+        }
+        notify([](const SimulationObserver& o) { if (o.onStepEnd) o.onStepEnd(); });
+    }
+
+    // 플레이어가 끝나고 군중이 모두 탈출하거나 갇힐 때까지(또는 timeLimit초까지) 진행하는 함수
+    // 프레임 간격으로 나누지 않고 다음 사건(화재 틱, 플레이어의 간선 도착, 군중의 가장 이른 간선 도착, 혼잡 반영) 시각으로 바로 건너뛰므로
+    // 창이 없으면 한 시간짜리 대피도 사건 수만큼의 step으로 끝난다
+    void runUntilDone(double timeLimit = std::numeric_limits<double>::infinity()) {
+        const double MIN_STEP = 1e-4; // 사건이 이보다 가까우면 묶어서 진행한다 (float 진행률이 1 바로 앞에서 멈추지 않도록)
+        while (!done() && now < timeLimit) {
+            double dt = std::min(config.fireTick - sinceFire, timeLimit - now);
+            if (playerStatus == AgentStatus::Moving) {
+                int e = graph->edge(path[currentPathIndex], path[currentPathIndex + 1]);
+                dt = std::min(dt, (1.0 - interpolation) * travelTimes[e]);
+            }
+            dt = std::min(dt, agents->nextArrival());
+            dt = std::min(dt, nextReweight - agents->time());
+            step(std::max(dt, MIN_STEP));
+        }
+    }
+
+    bool done() const { return playerStatus != AgentStatus::Moving && agents->finished(); }
+
+    double time() const { return now; }
+    AgentStatus status() const { return playerStatus; }
+    const std::vector<int>& playerPath() const { return path; }
+    size_t pathPosition() const { return currentPathIndex; }  // 마지막으로 출발한 경로 노드의 위치
+    double progress() const { return interpolation; }  // 현재 간선의 진행률
+    double totalWeight() const { return weightSum; }  // 지나온 간선 가중치의 합
+    double escapeTime() const { return escapedAt; }
+    int replans() const { return plannerStats().replans; }  // 경로가 막혀 다시 찾은 횟수
+    double replanSeconds() const { return plannerStats().replanSeconds; }  // 경로를 다시 찾는 데 걸린 실제 시간의 합 (초)
+    PlannerStats plannerStats() const { return planner ? planner->stats() : PlannerStats(); }
+    const NodeBitset& fireNodes() const { return fire->burningNodes; }
+    Crowd& crowd() { return crowdForUpdate(); }  // 스냅샷과 나눠 갖고 있으면 복사한다 (snapshot이나 restore 뒤에는 전에 받은 참조를 쓰면 안 된다)
+    const Crowd& crowd() const { return *agents; }
+
+private:
+    template <typename Fn>
+    void notify(Fn fn) const {
+        for (const auto& observer : observers) fn(observer);
+    }
+
+    static SmokeConfig smokeConfig(const SimulationConfig& config) {
+        SmokeConfig smoke = config.smoke;
+        smoke.tick = config.fireTick;
+        return smoke;
+    }
+
+    static PlannerConfig plannerConfig(const SimulationConfig& config) {
+        PlannerConfig planning;
+        planning.fallbackRouteCount = config.fallbackRouteCount;
+        planning.precomputeFallbacks = config.precomputeFallbacks;
+        return planning;
+    }
+
+    static std::vector<ExitTree> buildExitTrees(const Graph& graph, const std::vector<int>& exits) {
+        std::vector<ExitTree> trees;
+        trees.reserve(exits.size());
+        for (int exit : exits) {
+            trees.emplace_back(graph, exit);
+        }
+        return trees;
+    }
+
+    static std::vector<const ExitTree*> treePointers(const std::vector<ExitTree>& trees) {
+        std::vector<const ExitTree*> pointers;
+        for (const auto& tree : trees) {
+            pointers.push_back(&tree);
+        }
+        return pointers;
+    }
+
+    // 군중을 고치기 전에 부르는 함수 (군중이나 탈출구 트리가 스냅샷과 갈라지며 복사되었으면 군중이 보는 트리를 지금의 트리로 바꾼다)
+    Crowd& crowdForUpdate() {
+        Crowd& crowd = agents.edit();
+        if (!exitTrees->empty() && crowd.exitTrees().front() != &exitTrees->front()) crowd.setExits(treePointers(*exitTrees));
+        return crowd;
+    }
+
+    // costChanges를 탈출구 트리에 반영하는 함수 (바뀐 간선이 없으면 트리를 고치지 않으므로 스냅샷과 계속 나눠 갖는다)
+    void updateTreeCosts() {
+        if (costChanges.empty()) return;
+        for (auto& tree : exitTrees.edit()) {
+            tree.updateEdgeCosts(costChanges);
+        }
+    }
+
+    // 탐색기에 넘기는 현재 상태
+    PlanContext planContext() {
+        PlanContext context;
+        context.graph = graph;
+        context.travelTimes = &travelTimes;
+        context.exits = &config.exits;
+        context.burningNodes = &fire->burningNodes;
+        context.fireField = &fire->fireField;
+        context.fireTime = fireTime;
+        context.exitTrees = &*exitTrees;
+        context.background = &fallbackBuild;
+        return context;
+    }
+
+    // 현재 경로의 노드 위치 인덱스와, 남은 경로 중 지나지 않았는데 불타는 노드 수를 다시 계산하는 함수 (0보다 크면 경로가 막힌 것)
+    // 경로를 바꿀 때만 경로 전체를 보고, 틱마다는 새로 불붙은 노드만 인덱스로 확인한다
+    void indexPath() {
+        pathIndex.assign(path);
+        burningAhead = 0;
+        for (size_t i = currentPathIndex; i < path.size(); ++i) {
+            if (fire->burningNodes.test(path[i]) && !passedNodes.test(path[i])) burningAhead++;
+        }
+    }
+
+    // 화재 한 틱: 새로 불붙은 노드를 반영하고 탈출구 트리, 연기, 군중을 갱신한 뒤 플레이어 경로가 막혔으면 다시 찾는다
+    void spreadFire() {
+        fireTime += config.fireTick;
+        FireState& state = fire.edit();
+        std::vector<int> ignited = state.fireField.ignite(fireTime);
+
+        // 새로 불붙은 노드와, 각 노드에 이미 불타던 인접 노드에서 번져 오는 것을 알린다
+        if (!ignited.empty()) notify([&](const SimulationObserver& o) { if (o.onIgnite) o.onIgnite(ignited); });
+        for (const auto& observer : observers) {
+            if (!observer.onFireSpread) continue;
+            for (int id : ignited) {
+                for (int slot = graph->reverseOffsets[id]; slot < graph->reverseOffsets[id + 1]; ++slot) {
+                    int source = graph->sources[slot];
+                    if (state.burningNodes.test(source)) observer.onFireSpread(source, id, travelTimes[graph->reverseEdges[slot]]);
+                }
+            }
+        }
+        for (int id : ignited) {
+            state.burningNodes.set(id);
+            if (pathIndex.position(id) >= static_cast<int>(currentPathIndex) && !passedNodes.test(id)) burningAhead++;
+        }
+        if (!ignited.empty()) {
+            for (auto& tree : exitTrees.edit()) {
+                tree.removeNodes(ignited);
+            }
+        }
+        state.smoke.step(state.burningNodes, costChanges);
+        crowdForUpdate().reweight(state.smoke.costs(), costChanges); // 연기 비용에 혼잡 비용을 곱해 반영
+        updateTreeCosts();
+        crowdForUpdate().onFire(state.burningNodes);
+
+        if (playerStatus == AgentStatus::Moving && burningAhead > 0) {
+            replan();
+        }
+    }
+
+    // 경로 재계산 (결과를 바로 기다리므로 스레드 풀에 넣지 않고 현재 스레드에서 찾는다)
+    // 풀에 넣고 기다리면 기다리는 동안 다른 작업(일괄 실행의 다른 시나리오 등)을 이 시나리오 안에서 실행할 수 있다
+    void replan() {
+        int from = path[currentPathIndex];
+        std::vector<int> newPath = planner.edit().replan(planContext(), from);
+
+        if (newPath.empty()) {
+            playerStatus = AgentStatus::Trapped;
+            notify([&](const SimulationObserver& o) { if (o.onPlayerFinished) o.onPlayerFinished(playerStatus); });
+            return;
+        }
+        path = newPath;
+        currentPathIndex = 0;
+        interpolation = 0.0;
+        indexPath();
+        notify([&](const SimulationObserver& o) { if (o.onPathChanged) o.onPathChanged(path); });
+    }
+
+    // 플레이어를 현재 간선을 따라 dt초만큼 이동시키는 함수 (간선 하나를 다 지나면 다음 간선은 다음 호출부터 진행한다)
+    void movePlayer(double dt) {
+        int e = graph->edge(path[currentPathIndex], path[currentPathIndex + 1]);
+        const double EPS = 1e-9; // step과 같은 오차
+        interpolation += dt / travelTimes[e];
+        if (interpolation < 1.0 - EPS) return;
+
+        interpolation = 0.0;
+        weightSum += graph->weights[e];
+        if (fire->burningNodes.test(path[currentPathIndex]) && !passedNodes.test(path[currentPathIndex])) burningAhead--; // 불타는 노드를 빠져나감
+        passedNodes.set(path[currentPathIndex]);
+        currentPathIndex++;
+        notify([&](const SimulationObserver& o) { if (o.onPlayerAdvance) o.onPlayerAdvance(currentPathIndex); });
+        if (currentPathIndex + 1 >= path.size()) {
+            playerStatus = AgentStatus::Escaped;
+            escapedAt = now;
+            notify([&](const SimulationObserver& o) { if (o.onPlayerFinished) o.onPlayerFinished(playerStatus); });
+        }
+    }
+
+    const Graph* graph;
+    std::vector<double> travelTimes;
+    SimulationConfig config;
+    std::vector<SimulationObserver> observers;
+    CopyOnWrite<FireState> fire;
+    CopyOnWrite<std::vector<ExitTree>> exitTrees;  // 탈출구별 최단 경로 트리 (화재가 퍼질 때마다 불탄 노드의 서브트리만 갱신)
+    CopyOnWrite<Crowd> agents;  // 플레이어와 함께 대피하는 군중
+    CopyOnWrite<Planner, ClonePlanner> planner;  // 처음 경로와 다시 찾는 경로를 모두 맡는 탐색기
+    std::vector<EdgeCostChange> costChanges;
+    TaskGroup fallbackBuild;  // 탐색기의 미리 계산 작업 (planner보다 먼저 소멸하며 작업이 끝날 때까지 기다린다)
+    std::vector<int> path;  // 플레이어의 현재 경로 (노드 ID)
+    size_t currentPathIndex;
+    double interpolation;
+    double weightSum;
+    NodeBitset passedNodes;  // 플레이어가 지나온 노드
+    PathIndex pathIndex;
+    int burningAhead;
+    AgentStatus playerStatus;
+    double now;  // 시뮬레이션 시각
+    double sinceFire;  // 마지막 화재 틱 이후 경과 시간
+    double fireTime;  // 화재 발생 후 경과한 화재 시간 (틱 단위로 늘어난다)
+    double nextReweight;  // 다음에 군중 혼잡을 반영할 군중 시각
+    double escapedAt;
+};
@@ -0,0 +1,177 @@
+#pragma once
+
+#include <vector>
+#include <cstdint>
+#include <cmath>
+#include <algorithm>
+
+#ifdef __AVX2__
+#include <immintrin.h>
+#endif
+
+#include "graph.h"
+#include "node_bitset.h"
+
+// 8개 레인을 가진 xoshiro128+ 난수 생성기 (AVX2로 빌드하면 8개의 난수를 한 번에 만든다)
+// 스칼라 경로와 SIMD 경로가 같은 정수 연산을 하므로 어느 쪽으로 빌드해도 같은 난수열이 나온다
+class LaneRandom {
+public:
+    static const int LANES = 8;
+
+    explicit LaneRandom(std::uint64_t seed) {
+        // splitmix64로 각 레인의 상태를 채운다
+        for (int i = 0; i < 4; ++i) {
+            for (int lane = 0; lane < LANES; ++lane) {
+                seed += 0x9E3779B97F4A7C15ULL;
+                std::uint64_t z = seed;
+                z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+                z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+                state[i][lane] = static_cast<std::uint32_t>((z ^ (z >> 31)) >> 32) | 1u;
+            }
+        }
+    }
+
+#ifdef __AVX2__
+    // [0, 1) 범위의 난수 8개
+    __m256 next() {
+        __m256i s0 = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(state[0]));
+        __m256i s1 = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(state[1]));
+        __m256i s2 = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(state[2]));
+        __m256i s3 = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(state[3]));
+
+        __m256i result = _mm256_add_epi32(s0, s3);
+        __m256i t = _mm256_slli_epi32(s1, 9);
+        s2 = _mm256_xor_si256(s2, s0);
+        s3 = _mm256_xor_si256(s3, s1);
+        s1 = _mm256_xor_si256(s1, s2);
+        s0 = _mm256_xor_si256(s0, s3);
+        s2 = _mm256_xor_si256(s2, t);
+        s3 = _mm256_or_si256(_mm256_slli_epi32(s3, 11), _mm256_srli_epi32(s3, 21));
+
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(state[0]), s0);
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(state[1]), s1);
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(state[2]), s2);
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(state[3]), s3);
+
+        // 상위 24비트를 [0, 1) 실수로 변환
+        return _mm256_mul_ps(_mm256_cvtepi32_ps(_mm256_srli_epi32(result, 8)), _mm256_set1_ps(1.0f / 16777216.0f));
+    }
+#endif
+
+    // [0, 1) 범위의 난수 8개를 out에 채운다
+    void next(float* out) {
+        for (int lane = 0; lane < LANES; ++lane) {
+            std::uint32_t s0 = state[0][lane], s1 = state[1][lane], s2 = state[2][lane], s3 = state[3][lane];
+            std::uint32_t result = s0 + s3;
+            std::uint32_t t = s1 << 9;
+            s2 ^= s0;
+            s3 ^= s1;
+            s1 ^= s2;
+            s0 ^= s3;
+            s2 ^= t;
+            s3 = (s3 << 11) | (s3 >> 21);
+            state[0][lane] = s0;
+            state[1][lane] = s1;
+            state[2][lane] = s2;
+            state[3][lane] = s3;
+            out[lane] = static_cast<float>(result >> 8) * (1.0f / 16777216.0f);
+        }
+    }
+
+private:
+    std::uint32_t state[4][LANES];
+};
+
+// 간선별 화재 위험률 설정
+// 간선 e의 위험률 = (도착 노드 종류별 기본 위험률) * referenceWeight / (간선 가중치)
+struct FireSpreadConfig {
+    double buildingRate = 0.5;  // 건물 노드로 번지는 기본 위험률 (1/초)
+    double roadRate = 0.2;  // 도로 노드(코드가 'R'로 시작)로 번지는 기본 위험률 (1/초)
+    double referenceWeight = 100.0;  // 기본 위험률이 그대로 적용되는 간선 가중치
+    double minWeight = 1.0;  // 가중치가 매우 작은 간선(건물 내부 연결)의 위험률 상한을 정하는 최소 가중치
+};
+
+// 간선마다 위험률을 두고 확률적으로 번지는 화재 모델
+// 간선 정보를 출발/도착/확률 배열(SoA)로 펼쳐 두고, 틱마다 8개 간선씩 SIMD로 한꺼번에 검사한다
+// 모델 자체는 읽기 전용이므로 여러 시나리오(복제본)가 하나의 모델을 공유하고 각자 상태 배열만 가진다
+class StochasticFireModel {
+public:
+    StochasticFireModel(const Graph& graph, const FireSpreadConfig& config, double tick) {
+        int m = static_cast<int>(graph.targets.size());
+        int padded = (m + LaneRandom::LANES - 1) / LaneRandom::LANES * LaneRandom::LANES;
+        // 남는 자리는 확률 0인 가짜 간선으로 채운다
+        sources.assign(padded, 0);
+        targets.assign(padded, 0);
+        probabilities.assign(padded, 0.0f);
+
+        for (int u = 0; u < graph.size(); ++u) {
+            for (int e = graph.offsets[u]; e < graph.offsets[u + 1]; ++e) {
+                int v = graph.targets[e];
+                double rate = (graph.codes[v][0] == 'R' ? config.roadRate : config.buildingRate)
+                    * config.referenceWeight / std::max(graph.weights[e], config.minWeight);
+                sources[e] = u;
+                targets[e] = v;
+                // 한 틱 동안 불이 간선을 건널 확률 (지수 분포)
+                probabilities[e] = static_cast<float>(1.0 - std::exp(-rate * tick));
+            }
+        }
+    }
+
+    // 한 틱 동안의 화재 확산: burning[u] == 1인 노드에서 나가는 간선마다 확률적으로 불이 번진다
+    // 새로 불붙은 노드는 ignited에 추가하고, burning에도 1로 표시한다 (틱 시작 시점의 상태만 보고 번진다)
+    void step(std::vector<std::int32_t>& burning, LaneRandom& rng, std::vector<int>& ignited) const {
+        size_t firstNew = ignited.size();
+        int count = static_cast<int>(sources.size());
+
+#ifdef __AVX2__
+        const __m256i one = _mm256_set1_epi32(1);
+        const __m256i zero = _mm256_setzero_si256();
+        for (int i = 0; i < count; i += LaneRandom::LANES) {
+            __m256i src = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(&sources[i]));
+            __m256i srcBurning = _mm256_cmpeq_epi32(_mm256_i32gather_epi32(burning.data(), src, 4), one);
+            if (_mm256_testz_si256(srcBurning, srcBurning)) continue; // 불타는 출발 노드가 없으면 난수를 뽑지 않는다
+
+            __m256i tgt = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(&targets[i]));
+            __m256i tgtUnburned = _mm256_cmpeq_epi32(_mm256_i32gather_epi32(burning.data(), tgt, 4), zero);
+            __m256i hit = _mm256_castps_si256(_mm256_cmp_ps(rng.next(), _mm256_loadu_ps(&probabilities[i]), _CMP_LT_OQ));
+            int mask = _mm256_movemask_ps(_mm256_castsi256_ps(_mm256_and_si256(_mm256_and_si256(srcBurning, tgtUnburned), hit)));
+            for (; mask; mask &= mask - 1) {
+                ignite(targets[i + lowestBit(static_cast<std::uint64_t>(mask))], burning, ignited);
+            }
+        }
+#else
+        float draws[LaneRandom::LANES];
+        for (int i = 0; i < count; i += LaneRandom::LANES) {
+            bool anyBurning = false;
+            for (int lane = 0; lane < LaneRandom::LANES; ++lane) {
+                if (burning[sources[i + lane]] == 1) anyBurning = true;
+            }
+            if (!anyBurning) continue; // 불타는 출발 노드가 없으면 난수를 뽑지 않는다
+
+            rng.next(draws);
+            for (int lane = 0; lane < LaneRandom::LANES; ++lane) {
+                if (burning[sources[i + lane]] == 1 && burning[targets[i + lane]] == 0 && draws[lane] < probabilities[i + lane]) {
+                    ignite(targets[i + lane], burning, ignited);
+                }
+            }
+        }
+#endif
+
+        // 이번 틱에 불붙은 노드(2)를 불타는 상태(1)로 확정
+        for (size_t i = firstNew; i < ignited.size(); ++i) {
+            burning[ignited[i]] = 1;
+        }
+    }
+
+private:
+    // 이번 틱에 불붙은 노드는 2로 표시하여 같은 틱 안에서 다시 번지지 않도록 한다
+    static void ignite(int v, std::vector<std::int32_t>& burning, std::vector<int>& ignited) {
+        if (burning[v] != 0) return;
+        burning[v] = 2;
+        ignited.push_back(v);
+    }
+
+    std::vector<std::int32_t> sources;  // 간선의 출발 노드 ID
+    std::vector<std::int32_t> targets;  // 간선의 도착 노드 ID
+    std::vector<float> probabilities;  // 한 틱 동안 불이 간선을 건널 확률
+};
@@ -0,0 +1,233 @@
+#pragma once
+
+#include <vector>
+#include <deque>
+#include <memory>
+#include <functional>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <atomic>
+#include <algorithm>
+
+// 작업 우선순위 (높은 우선순위의 작업이 하나라도 남아 있으면 낮은 우선순위 작업은 꺼내지 않는다)
+// 우선순위는 큐에서 꺼내는 순서만 정하며 이미 실행 중인 작업을 멈추지는 않는다.
+// 결과를 바로 기다리는 작업(경로 재계산 등)은 풀에 넣지 않고 기다리는 스레드에서 직접 실행한다.
+enum class TaskPriority {
+    Normal = 0,  // 에이전트 갱신, 몬테카를로 시나리오
+    Background = 1  // 대체 경로 같은 미리 계산
+};
+
+// 스레드 풀 상태 (작업 중에 읽으면 근사값)
+struct ThreadPoolStats {
+    int workers = 0;  // 작업 스레드 수
+    int queued[2] = { 0, 0 };  // 우선순위별 대기 중인 작업 수
+    int peakQueued = 0;  // 대기 작업 수의 최댓값
+    long long executed = 0;  // 실행한 작업 수
+    long long steals = 0;  // 다른 스레드의 큐에서 가져온 작업 수
+};
+
+// 작업 훔치기(work stealing) 스레드 풀
+// 작업 스레드마다 우선순위별 큐를 두고, 자기 큐에서는 가장 최근에 넣은 작업을(캐시에 남아 있을 가능성이 높다),
+// 다른 스레드의 큐에서는 가장 오래된 작업을 가져온다. 작업 스레드가 아닌 스레드가 넣은 작업은 큐를 돌아가며 나눠 넣는다.
+class ThreadPool {
+public:
+    // workers가 0이면 하드웨어 스레드 수 - 1 (작업을 기다리는 스레드도 TaskGroup::wait에서 작업을 실행하므로)
+    explicit ThreadPool(int workers = 0) : stopping(false), pending(0), peak(0), executed(0), steals(0), nextQueue(0) {
+        if (workers <= 0) workers = std::max(1, static_cast<int>(std::thread::hardware_concurrency()) - 1);
+        for (auto& count : queuedCounts) count.store(0);
+        for (int i = 0; i < workers; ++i) {
+            queues.emplace_back(new Queue());
+        }
+        for (int i = 0; i < workers; ++i) {
+            threads.emplace_back([this, i]() { workerLoop(i); });
+        }
+    }
+
+    ~ThreadPool() {
+        {
+            std::lock_guard<std::mutex> lock(sleepMutex);
+            stopping = true;
+        }
+        wake.notify_all();
+        for (auto& thread : threads) {
+            thread.join();
+        }
+    }
+
+    ThreadPool(const ThreadPool&) = delete;
+    ThreadPool& operator=(const ThreadPool&) = delete;
+
+    // 작업을 넣는 함수 (작업 스레드 안에서 넣으면 자기 큐에, 밖에서 넣으면 돌아가며 나눠 넣는다)
+    void submit(std::function<void()> task, TaskPriority priority = TaskPriority::Normal) {
+        int p = static_cast<int>(priority);
+        int self = workerIndex();
+        int target = self >= 0 ? self : static_cast<int>(nextQueue++ % queues.size());
+        {
+            std::lock_guard<std::mutex> lock(queues[target]->mutex);
+            queues[target]->tasks[p].push_back(std::move(task));
+        }
+        queuedCounts[p]++;
+        int depth = ++pending;
+        for (int seen = peak.load(); depth > seen && !peak.compare_exchange_weak(seen, depth);) {}
+        {
+            std::lock_guard<std::mutex> lock(sleepMutex);
+        }
+        wake.notify_one();
+    }
+
+    // 대기 중인 작업 중 우선순위가 가장 높은 것 하나를 현재 스레드에서 실행하는 함수 (실행할 작업이 없으면 false)
+    bool runPending() {
+        return runOne(workerIndex());
+    }
+
+    int size() const { return static_cast<int>(threads.size()); }
+
+    ThreadPoolStats stats() const {
+        ThreadPoolStats result;
+        result.workers = size();
+        for (int p = 0; p < 2; ++p) result.queued[p] = queuedCounts[p].load();
+        result.peakQueued = peak.load();
+        result.executed = executed.load();
+        result.steals = steals.load();
+        return result;
+    }
+
+private:
+    struct Queue {
+        std::mutex mutex;
+        std::deque<std::function<void()>> tasks[2];  // 우선순위별 작업
+    };
+
+    // 현재 스레드가 이 풀의 몇 번째 작업 스레드인지 (작업 스레드가 아니면 -1)
+    int workerIndex() const {
+        return currentPool() == this ? currentIndex() : -1;
+    }
+
+    static const ThreadPool*& currentPool() {
+        static thread_local const ThreadPool* pool = nullptr;
+        return pool;
+    }
+
+    static int& currentIndex() {
+        static thread_local int index = -1;
+        return index;
+    }
+
+    void workerLoop(int index) {
+        currentPool() = this;
+        currentIndex() = index;
+        while (true) {
+            if (runOne(index)) continue;
+            std::unique_lock<std::mutex> lock(sleepMutex);
+            wake.wait(lock, [this]() { return stopping || pending.load() > 0; });
+            if (stopping && pending.load() == 0) return;
+        }
+    }
+
+    // 우선순위마다 자기 큐의 뒤쪽, 다른 큐의 앞쪽 순으로 작업을 찾아 하나 실행하는 함수
+    bool runOne(int self) {
+        int count = static_cast<int>(queues.size());
+        for (int p = 0; p < 2; ++p) {
+            if (queuedCounts[p].load() == 0) continue;
+            std::function<void()> task;
+            if (self >= 0) {
+                std::lock_guard<std::mutex> lock(queues[self]->mutex);
+                auto& tasks = queues[self]->tasks[p];
+                if (!tasks.empty()) {
+                    task = std::move(tasks.back());
+                    tasks.pop_back();
+                }
+            }
+            for (int k = 1; !task && k <= count; ++k) {
+                int victim = ((self >= 0 ? self : 0) + k) % count;
+                if (victim == self) continue;
+                std::lock_guard<std::mutex> lock(queues[victim]->mutex);
+                auto& tasks = queues[victim]->tasks[p];
+                if (!tasks.empty()) {
+                    task = std::move(tasks.front());
+                    tasks.pop_front();
+                    steals++;
+                }
+            }
+            if (task) {
+                queuedCounts[p]--;
+                pending--;
+                task();
+                executed++;
+                return true;
+            }
+        }
+        return false;
+    }
+
+    std::vector<std::unique_ptr<Queue>> queues;  // 작업 스레드별 큐
+    std::vector<std::thread> threads;
+    std::mutex sleepMutex;  // 할 일이 없는 작업 스레드가 기다리는 곳
+    std::condition_variable wake;
+    bool stopping;
+    std::atomic<int> pending;  // 모든 큐의 대기 작업 수
+    std::atomic<int> queuedCounts[2];  // 우선순위별 대기 작업 수
+    std::atomic<int> peak;
+    std::atomic<long long> executed;
+    std::atomic<long long> steals;
+    std::atomic<unsigned> nextQueue;  // 작업 스레드가 아닌 스레드가 다음에 작업을 넣을 큐
+};
+
+// 프로그램 전체가 같이 쓰는 스레드 풀 (처음 쓸 때 하드웨어 스레드 수에 맞춰 만든다)
+inline ThreadPool& sharedPool() {
+    static ThreadPool pool;
+    return pool;
+}
+
+// 함께 기다릴 작업 묶음
+// wait는 작업이 모두 끝날 때까지 대기 중인 작업을 직접 실행하므로, 작업 스레드 안에서 기다려도 교착되지 않는다
+class TaskGroup {
+public:
+    explicit TaskGroup(ThreadPool& pool) : pool(&pool), remaining(0) {}
+    ~TaskGroup() { wait(); }
+
+    TaskGroup(const TaskGroup&) = delete;
+    TaskGroup& operator=(const TaskGroup&) = delete;
+
+    template <typename Fn>
+    void run(Fn fn, TaskPriority priority = TaskPriority::Normal) {
+        remaining++;
+        pool->submit([this, fn]() mutable {
+            fn();
+            remaining--; // 마지막으로 그룹에 접근하는 곳 (이후 그룹이 사라져도 된다)
+        }, priority);
+    }
+
+    void wait() {
+        while (remaining.load() > 0) {
+            if (!pool->runPending()) std::this_thread::yield();
+        }
+    }
+
+    bool done() const { return remaining.load() == 0; }
+
+private:
+    ThreadPool* pool;
+    std::atomic<int> remaining;
+};
+
+// [0, count) 구간을 threads개로 나누어 fn(begin, end, chunk)를 스레드 풀에서 병렬로 호출하는 함수 (작은 작업은 현재 스레드에서 바로 처리)
+// 구간 경계는 count와 threads로만 정해지므로, 풀의 스레드 수와 관계없이 같은 chunk에는 같은 구간이 전달된다
+template <typename RangeFn>
+void parallelFor(int count, int threads, RangeFn fn, TaskPriority priority = TaskPriority::Normal) {
+    const int MIN_CHUNK = 4096; // 작업을 나누는 비용보다 일이 적으면 나누지 않는다
+    int chunks = std::max(1, std::min(threads, count / MIN_CHUNK));
+    if (chunks == 1) {
+        fn(0, count, 0);
+        return;
+    }
+    TaskGroup group(sharedPool());
+    for (int c = 1; c < chunks; ++c) {
+        int begin = static_cast<int>(static_cast<long long>(count) * c / chunks);
+        int end = static_cast<int>(static_cast<long long>(count) * (c + 1) / chunks);
+        group.run([&fn, begin, end, c]() { fn(begin, end, c); }, priority);
+    }
+    fn(0, count / chunks, 0);
+    group.wait();
+}
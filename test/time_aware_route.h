@@ -0,0 +1,78 @@
+#pragma once
+
+#include <vector>
+#include <queue>
+#include <limits>
+#include <algorithm>
+#include <cmath>
+
+#include "graph.h"
+#include "node_bitset.h"
+#include "fire.h"
+
+// 화재 도달 시각을 고려하여 불보다 먼저 탈출구에 도착하는 경로를 찾는 함수 (시간 의존 다익스트라)
+// departTime에 startId를 출발해 간선 e를 travelTime(e)만큼 걸려 지난다고 할 때,
+// 플레이어가 노드를 떠나 다음 노드에 도착하기 전에 불이 붙는 노드는 지나지 않는다.
+// 도착 시각이 ARRIVAL_EPS 안에서 같은 경로가 여럿이면 화재 도달 시각과의 여유(safety margin)가 가장 큰 경로를 고른다.
+template <typename TravelTimeFn>
+std::vector<int> timeAwareRoute(const Graph& graph, int startId, int exitId, const FireField& fire, double departTime, TravelTimeFn travelTime) {
+    const double INF = std::numeric_limits<double>::infinity();
+    const double ARRIVAL_EPS = 1e-6; // 도착 시각을 같다고 볼 오차 (초): 이동 시간을 더한 순서가 다른 경로의 도착 시각은 비트 단위로 같지 않다
+    std::vector<double> arrival(graph.size(), INF); // 플레이어가 노드에 도착하는 시각
+    std::vector<double> margin(graph.size(), -INF); // 지금까지 지나온 노드들의 최소 시간 여유
+    std::vector<int> previous(graph.size(), -1);
+    NodeBitset settled(graph.size());
+
+    // (도착 시각 칸, 시간 여유) 순으로 비교: 도착 시각을 ARRIVAL_EPS 단위로 반올림한 칸이 빠를수록, 같은 칸이면 여유가 클수록 먼저 꺼낸다
+    // (오차 안이면 같다고 보는 비교는 추이적이지 않아 우선순위 큐의 순서가 깨지므로 칸 번호로 비교한다)
+    struct Entry {
+        long long slot;
+        double margin;
+        int node;
+        bool operator>(const Entry& other) const {
+            if (slot != other.slot) return slot > other.slot;
+            return margin < other.margin;
+        }
+    };
+    std::priority_queue<Entry, std::vector<Entry>, std::greater<Entry>> queue;
+
+    arrival[startId] = departTime;
+    margin[startId] = INF;
+    queue.push({ std::llround(departTime / ARRIVAL_EPS), INF, startId });
+
+    while (!queue.empty()) {
+        int u = queue.top().node;
+        queue.pop();
+        if (!settled.insert(u)) continue;
+        if (u == exitId) break;
+
+        // 플레이어가 이미 서 있는 시작 노드는 불타고 있어도 빠져나갈 수 있다
+        bool leavingBurningStart = (u == startId && fire.arrival(u) <= departTime);
+
+        for (int e = graph.offsets[u]; e < graph.offsets[u + 1]; ++e) {
+            int v = graph.targets[e];
+            if (settled.test(v)) continue; // 이미 확정된 노드의 경로는 바꾸지 않는다
+            double t = arrival[u] + travelTime(e);
+            double m = std::min(margin[u], fire.arrival(v) - t);
+            if (!leavingBurningStart) m = std::min(m, fire.arrival(u) - t);
+            if (m <= 0.0) continue; // 플레이어보다 불이 먼저 도달하는 경우
+
+            if (t < arrival[v] - ARRIVAL_EPS || (t <= arrival[v] + ARRIVAL_EPS && m > margin[v])) {
+                arrival[v] = t;
+                margin[v] = m;
+                previous[v] = u;
+                queue.push({ std::llround(t / ARRIVAL_EPS), m, v });
+            }
+        }
+    }
+
+    if (arrival[exitId] == INF) {
+        return {}; // 불보다 먼저 탈출할 수 있는 경로가 없는 경우
+    }
+    std::vector<int> path;
+    for (int at = exitId; at != -1; at = previous[at]) {
+        path.push_back(at);
+    }
+    std::reverse(path.begin(), path.end());
+    return path;
+}